@@ -0,0 +1,248 @@
+////////////////////////////////////////////////////////////////////////////////
+// Scaling benchmark of the nonlinear solvers on synthetic problems.
+//
+// Runs every problem × size × solver × line search combination and writes one
+// JSON line per run: iterations, status, evaluation counts, time per phase (as
+// in the solver info, per iteration), and the peak resident memory of the run.
+// The peak is reset before each run through /proc/self/clear_refs, so it is only
+// reported on Linux.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "problems.hpp"
+
+#include <polysolve/nonlinear/Solver.hpp>
+#include <polysolve/nonlinear/line_search/LineSearch.hpp>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace polysolve;
+
+namespace
+{
+    const char *USAGE = R"(Usage: polysolve_nl_bench [options]
+  --problems a,b,...       laplacian, rosenbrock, barrier (default: all)
+  --sizes n,...            Number of dofs (default: 1e3,1e4,1e5)
+  --solvers a,b,...        Nonlinear solvers (default: all)
+  --line-searches a,b,...  Line search methods (default: all)
+  --linear-solver name     Linear solver of the Newton strategies (default: Eigen::SimplicialLDLT)
+  --max-iterations n       Iteration limit of each run (default: 1000)
+  --dense-limit n          Skip the dense strategies above n dofs (default: 10000)
+  --seed n                 Seed of the problem data and initial guess (default: 0)
+  --output path            JSON lines output (default: stdout)
+)";
+
+    std::vector<std::string> split(const std::string &list)
+    {
+        std::vector<std::string> res;
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                res.push_back(item);
+        return res;
+    }
+
+    /// Resets the peak resident set size to the current one, returns false if unsupported
+    bool reset_peak_memory()
+    {
+#ifdef __linux__
+#ifdef __GLIBC__
+        // Give the memory freed by the previous runs back to the system first
+        malloc_trim(0);
+#endif
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        clear_refs.close();
+        return !clear_refs.fail();
+#else
+        return false;
+#endif
+    }
+
+    /// Peak resident set size since the last reset_peak_memory in MB, negative if unknown
+    double peak_memory_mb()
+    {
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+            if (line.rfind("VmHWM:", 0) == 0)
+                return std::stod(line.substr(6)) / 1024.; // kB
+#endif
+        return -1;
+    }
+
+    bool is_dense_solver(const std::string &name)
+    {
+        return name == "DenseNewton" || name == "BFGS";
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> problems = bench::available_problems();
+    std::vector<int> sizes = {1000, 10000, 100000};
+    std::vector<std::string> solvers = nonlinear::Solver::available_solvers();
+    std::vector<std::string> line_searches = nonlinear::line_search::LineSearch::available_methods();
+    std::string linear_solver = "Eigen::SimplicialLDLT";
+    int max_iterations = 1000;
+    int dense_limit = 10000;
+    unsigned seed = 0;
+    std::string output;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help")
+            {
+                std::cout << USAGE;
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 >= argc)
+                throw std::runtime_error("Missing value of " + arg);
+            const std::string value = argv[++i];
+
+            if (arg == "--problems")
+                problems = split(value);
+            else if (arg == "--sizes")
+            {
+                sizes.clear();
+                for (const std::string &s : split(value))
+                    sizes.push_back(int(std::stod(s))); // allows 1e6
+            }
+            else if (arg == "--solvers")
+                solvers = split(value);
+            else if (arg == "--line-searches")
+                line_searches = split(value);
+            else if (arg == "--linear-solver")
+                linear_solver = value;
+            else if (arg == "--max-iterations")
+                max_iterations = std::stoi(value);
+            else if (arg == "--dense-limit")
+                dense_limit = std::stoi(value);
+            else if (arg == "--seed")
+                seed = unsigned(std::stoul(value));
+            else if (arg == "--output")
+                output = value;
+            else
+                throw std::runtime_error("Unknown option " + arg);
+        }
+
+        const std::vector<std::string> available = bench::available_problems();
+        for (const std::string &name : problems)
+            if (std::find(available.begin(), available.end(), name) == available.end())
+                throw std::runtime_error("Unknown problem " + name);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n"
+                  << USAGE;
+        return EXIT_FAILURE;
+    }
+
+    std::sort(sizes.begin(), sizes.end());
+
+    std::ofstream file;
+    if (!output.empty())
+    {
+        file.open(output);
+        if (!file.is_open())
+        {
+            std::cerr << "Unable to open " << output << " for writing\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &out = output.empty() ? std::cout : file;
+
+    auto logger = spdlog::stderr_color_mt("polysolve_nl_bench");
+    logger->set_level(spdlog::level::off);
+
+    for (const std::string &problem_name : problems)
+    {
+        for (const int n : sizes)
+        {
+            std::unique_ptr<bench::BenchProblem> problem = bench::make_problem(problem_name, n, seed);
+
+            for (const std::string &solver_name : solvers)
+            {
+                for (const std::string &line_search : line_searches)
+                {
+                    json run;
+                    run["problem"] = problem->name();
+                    run["size"] = n;
+                    run["dofs"] = problem->size();
+                    run["solver"] = solver_name;
+                    run["line_search"] = line_search;
+                    run["seed"] = seed;
+
+                    if (is_dense_solver(solver_name) && problem->size() > dense_limit)
+                    {
+                        run["status"] = "skipped";
+                        out << run.dump() << std::endl;
+                        continue;
+                    }
+
+                    json solver_params, linear_solver_params;
+                    solver_params["solver"] = solver_name;
+                    solver_params["line_search"]["method"] = line_search;
+                    solver_params["max_iterations"] = max_iterations;
+                    linear_solver_params["solver"] = linear_solver;
+
+                    nonlinear::Problem::TVector x = problem->initial_guess();
+                    problem->reset_evaluations();
+                    const bool measure_memory = reset_peak_memory();
+
+                    const auto start = std::chrono::steady_clock::now();
+                    try
+                    {
+                        auto solver = nonlinear::Solver::create(solver_params, linear_solver_params, 1, *logger);
+                        solver->allow_out_of_iterations = true;
+                        solver->minimize(*problem, x);
+
+                        const json &info = solver->info();
+                        run["status"] = std::string(nonlinear::status_message(solver->status()));
+                        run["converged"] = nonlinear::is_converged_status(solver->status());
+                        run["iterations"] = info["iterations"];
+                        run["energy"] = info["energy"];
+                        run["grad_norm"] = info["gradNorm"];
+                        for (const auto &[key, value] : info.items())
+                            if (key.rfind("time_", 0) == 0 || key == "total_time")
+                                run["times"][key] = value;
+                    }
+                    catch (const std::exception &e)
+                    {
+                        run["status"] = "error";
+                        run["error"] = e.what();
+                    }
+                    run["wall_time"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                    const bench::BenchProblem::Evaluations &evaluations = problem->evaluations();
+                    run["evaluations"]["value"] = evaluations.value;
+                    run["evaluations"]["gradient"] = evaluations.gradient;
+                    run["evaluations"]["hessian"] = evaluations.hessian;
+
+                    const double peak = measure_memory ? peak_memory_mb() : -1;
+                    if (peak >= 0)
+                        run["peak_memory_mb"] = peak;
+
+                    out << run.dump() << std::endl;
+                }
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
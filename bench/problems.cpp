@@ -0,0 +1,234 @@
+#include "problems.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace polysolve::bench
+{
+    namespace
+    {
+        using TVector = nonlinear::Problem::TVector;
+
+        constexpr double PI = 3.14159265358979323846;
+
+        /// Uniform values in [lo, hi), reproducible for a given seed
+        TVector random_vector(const int n, const double lo, const double hi, std::mt19937 &gen)
+        {
+            std::uniform_real_distribution<double> dist(lo, hi);
+            TVector v(n);
+            for (int i = 0; i < n; ++i)
+                v[i] = dist(gen);
+            return v;
+        }
+    } // namespace
+
+    // =========================================================================
+
+    GridLaplacian::GridLaplacian(const int n, const unsigned seed)
+        : k(std::max(2, int(std::ceil(std::sqrt(double(n))))))
+    {
+        edges.reserve(2 * k * (k - 1));
+        for (int i = 0; i < k; ++i)
+        {
+            for (int j = 0; j < k; ++j)
+            {
+                const int v = i * k + j;
+                if (j + 1 < k)
+                    edges.emplace_back(v, v + 1);
+                if (i + 1 < k)
+                    edges.emplace_back(v, v + k);
+            }
+        }
+
+        std::mt19937 gen(seed);
+        load = random_vector(size(), 0.9, 1.1, gen);
+        x0 = random_vector(size(), -1, 1, gen);
+    }
+
+    GridLaplacian::Scalar GridLaplacian::energy(const TVector &x) const
+    {
+        double e = 0;
+        for (const auto &[i, j] : edges)
+        {
+            const double t = x[i] - x[j];
+            e += 0.5 * t * t + 0.25 * alpha * t * t * t * t;
+        }
+        return e + 0.5 * mass * x.squaredNorm() - load.dot(x);
+    }
+
+    void GridLaplacian::energy_gradient(const TVector &x, TVector &grad) const
+    {
+        grad = mass * x - load;
+        for (const auto &[i, j] : edges)
+        {
+            const double t = x[i] - x[j];
+            const double d = t + alpha * t * t * t;
+            grad[i] += d;
+            grad[j] -= d;
+        }
+    }
+
+    void GridLaplacian::energy_hessian(const TVector &x, THessian &hessian) const
+    {
+        std::vector<Eigen::Triplet<double>> entries;
+        entries.reserve(4 * edges.size() + size());
+        for (const auto &[i, j] : edges)
+        {
+            const double t = x[i] - x[j];
+            const double w = 1 + 3 * alpha * t * t;
+            entries.emplace_back(i, i, w);
+            entries.emplace_back(j, j, w);
+            entries.emplace_back(i, j, -w);
+            entries.emplace_back(j, i, -w);
+        }
+        for (int i = 0; i < size(); ++i)
+            entries.emplace_back(i, i, mass);
+
+        hessian.resize(size(), size());
+        hessian.setFromTriplets(entries.begin(), entries.end());
+    }
+
+    // =========================================================================
+
+    ExtendedRosenbrock::ExtendedRosenbrock(const int n, const unsigned seed)
+        : n(std::max(2, n + n % 2))
+    {
+        std::mt19937 gen(seed);
+        x0 = random_vector(this->n, -0.01, 0.01, gen);
+        for (int i = 0; i < this->n; i += 2)
+        {
+            x0[i] += -1.2;
+            x0[i + 1] += 1;
+        }
+    }
+
+    ExtendedRosenbrock::Scalar ExtendedRosenbrock::energy(const TVector &x) const
+    {
+        double e = 0;
+        for (int i = 0; i < n; i += 2)
+        {
+            const double a = x[i], b = x[i + 1];
+            e += 100 * (b - a * a) * (b - a * a) + (1 - a) * (1 - a);
+        }
+        return e;
+    }
+
+    void ExtendedRosenbrock::energy_gradient(const TVector &x, TVector &grad) const
+    {
+        grad.resize(n);
+        for (int i = 0; i < n; i += 2)
+        {
+            const double a = x[i], b = x[i + 1];
+            grad[i] = -400 * a * (b - a * a) - 2 * (1 - a);
+            grad[i + 1] = 200 * (b - a * a);
+        }
+    }
+
+    void ExtendedRosenbrock::energy_hessian(const TVector &x, THessian &hessian) const
+    {
+        std::vector<Eigen::Triplet<double>> entries;
+        entries.reserve(2 * n);
+        for (int i = 0; i < n; i += 2)
+        {
+            const double a = x[i], b = x[i + 1];
+            entries.emplace_back(i, i, 1200 * a * a - 400 * b + 2);
+            entries.emplace_back(i, i + 1, -400 * a);
+            entries.emplace_back(i + 1, i, -400 * a);
+            entries.emplace_back(i + 1, i + 1, 200);
+        }
+
+        hessian.resize(n, n);
+        hessian.setFromTriplets(entries.begin(), entries.end());
+    }
+
+    // =========================================================================
+
+    BarrierChain::BarrierChain(const int n, const unsigned seed)
+        : n(std::max(2, n))
+    {
+        std::mt19937 gen(seed);
+        target = random_vector(this->n, -0.1, 0.1, gen);
+        for (int i = 0; i < this->n; ++i)
+            target[i] += std::sin(8 * PI * i / this->n);
+        x0 = random_vector(this->n, 1, 1.1, gen);
+    }
+
+    BarrierChain::Scalar BarrierChain::energy(const TVector &x) const
+    {
+        if ((x.array() <= 0).any())
+            return std::numeric_limits<double>::infinity();
+
+        const auto dx = x.tail(n - 1) - x.head(n - 1);
+        return 0.5 * stiffness * dx.squaredNorm()
+               + 0.5 * (x - target).squaredNorm()
+               - kappa * x.array().log().sum();
+    }
+
+    void BarrierChain::energy_gradient(const TVector &x, TVector &grad) const
+    {
+        grad = (x - target).array() - kappa / x.array();
+        for (int i = 0; i + 1 < n; ++i)
+        {
+            const double d = stiffness * (x[i + 1] - x[i]);
+            grad[i] -= d;
+            grad[i + 1] += d;
+        }
+    }
+
+    void BarrierChain::energy_hessian(const TVector &x, THessian &hessian) const
+    {
+        std::vector<Eigen::Triplet<double>> entries;
+        entries.reserve(3 * n);
+        for (int i = 0; i < n; ++i)
+        {
+            const int neighbours = (i > 0) + (i + 1 < n);
+            entries.emplace_back(i, i, 1 + neighbours * stiffness + kappa / (x[i] * x[i]));
+            if (i + 1 < n)
+            {
+                entries.emplace_back(i, i + 1, -stiffness);
+                entries.emplace_back(i + 1, i, -stiffness);
+            }
+        }
+
+        hessian.resize(n, n);
+        hessian.setFromTriplets(entries.begin(), entries.end());
+    }
+
+    bool BarrierChain::is_step_valid(const TVector &x0, const TVector &x1)
+    {
+        return (x1.array() > 0).all();
+    }
+
+    double BarrierChain::max_step_size(const TVector &x0, const TVector &x1)
+    {
+        double step = 1;
+        for (int i = 0; i < n; ++i)
+        {
+            const double d = x1[i] - x0[i];
+            if (d < 0)
+                step = std::min(step, fraction_to_boundary * x0[i] / -d);
+        }
+        return step;
+    }
+
+    // =========================================================================
+
+    std::vector<std::string> available_problems()
+    {
+        return {"laplacian", "rosenbrock", "barrier"};
+    }
+
+    std::unique_ptr<BenchProblem> make_problem(const std::string &name, const int n, const unsigned seed)
+    {
+        if (name == "laplacian")
+            return std::make_unique<GridLaplacian>(n, seed);
+        else if (name == "rosenbrock")
+            return std::make_unique<ExtendedRosenbrock>(n, seed);
+        else if (name == "barrier")
+            return std::make_unique<BarrierChain>(n, seed);
+        throw std::runtime_error("Unknown benchmark problem " + name);
+    }
+} // namespace polysolve::bench
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <polysolve/nonlinear/Problem.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace polysolve::bench
+{
+    /// @brief Synthetic problem of arbitrary size, counting its evaluations
+    class BenchProblem : public nonlinear::Problem
+    {
+    public:
+        struct Evaluations
+        {
+            size_t value = 0;
+            size_t gradient = 0;
+            size_t hessian = 0;
+        };
+
+        Scalar value(const TVector &x) override
+        {
+            ++m_evaluations.value;
+            return energy(x);
+        }
+
+        void gradient(const TVector &x, TVector &grad) override
+        {
+            ++m_evaluations.gradient;
+            energy_gradient(x, grad);
+        }
+
+        void hessian(const TVector &x, THessian &hessian) override
+        {
+            ++m_evaluations.hessian;
+            energy_hessian(x, hessian);
+        }
+
+        void hessian(const TVector &x, TMatrix &hessian) override
+        {
+            THessian sparse;
+            this->hessian(x, sparse);
+            hessian = sparse;
+        }
+
+        const Evaluations &evaluations() const { return m_evaluations; }
+        void reset_evaluations() { m_evaluations = Evaluations(); }
+
+        virtual std::string name() const = 0;
+
+        /// @brief Number of degrees of freedom
+        virtual int size() const = 0;
+
+        /// @brief Reproducible starting point
+        virtual TVector initial_guess() const = 0;
+
+    protected:
+        virtual Scalar energy(const TVector &x) const = 0;
+        virtual void energy_gradient(const TVector &x, TVector &grad) const = 0;
+        virtual void energy_hessian(const TVector &x, THessian &hessian) const = 0;
+
+    private:
+        Evaluations m_evaluations;
+    };
+
+    /// @brief Nonlinear Laplacian on a k×k grid (k = ⌈√n⌉): springs φ(t) = t²/2 + αt⁴/4 between
+    /// neighbours, a mass term, and a load. Convex, with the sparsity of a 2D stiffness matrix.
+    class GridLaplacian : public BenchProblem
+    {
+    public:
+        GridLaplacian(const int n, const unsigned seed);
+
+        std::string name() const override { return "laplacian"; }
+        int size() const override { return k * k; }
+        TVector initial_guess() const override { return x0; }
+
+    protected:
+        Scalar energy(const TVector &x) const override;
+        void energy_gradient(const TVector &x, TVector &grad) const override;
+        void energy_hessian(const TVector &x, THessian &hessian) const override;
+
+    private:
+        int k;
+        std::vector<std::pair<int, int>> edges;
+        TVector load;
+        TVector x0;
+
+        static constexpr double alpha = 1;
+        static constexpr double mass = 1e-2;
+    };
+
+    /// @brief Extended Rosenbrock, Σ 100 (x₂ᵢ₊₁ - x₂ᵢ²)² + (1 - x₂ᵢ)², with 2×2 diagonal Hessian blocks
+    class ExtendedRosenbrock : public BenchProblem
+    {
+    public:
+        ExtendedRosenbrock(const int n, const unsigned seed);
+
+        std::string name() const override { return "rosenbrock"; }
+        int size() const override { return n; }
+        TVector initial_guess() const override { return x0; }
+
+    protected:
+        Scalar energy(const TVector &x) const override;
+        void energy_gradient(const TVector &x, TVector &grad) const override;
+        void energy_hessian(const TVector &x, THessian &hessian) const override;
+
+    private:
+        int n;
+        TVector x0;
+    };
+
+    /// @brief Chain pulled towards targets of both signs with a log barrier keeping x > 0.
+    /// Steps leaving the domain are invalid and max_step_size stops at a fraction of the
+    /// distance to the boundary, as with contact barriers.
+    class BarrierChain : public BenchProblem
+    {
+    public:
+        BarrierChain(const int n, const unsigned seed);
+
+        std::string name() const override { return "barrier"; }
+        int size() const override { return n; }
+        TVector initial_guess() const override { return x0; }
+
+        bool is_step_valid(const TVector &x0, const TVector &x1) override;
+        double max_step_size(const TVector &x0, const TVector &x1) override;
+
+    protected:
+        Scalar energy(const TVector &x) const override;
+        void energy_gradient(const TVector &x, TVector &grad) const override;
+        void energy_hessian(const TVector &x, THessian &hessian) const override;
+
+    private:
+        int n;
+        TVector target;
+        TVector x0;
+
+        static constexpr double stiffness = 1;
+        static constexpr double kappa = 1e-3;
+        static constexpr double fraction_to_boundary = 0.99;
+    };
+
+    std::vector<std::string> available_problems();
+
+    /// @brief Create a problem with about n dofs, the seed perturbs its data and initial guess
+    std::unique_ptr<BenchProblem> make_problem(const std::string &name, const int n, const unsigned seed);
+} // namespace polysolve::bench
@@ -0,0 +1,435 @@
+#include "BinaryIO.hpp"
+
+#include <unsupported/Eigen/SparseExtra>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace polysolve
+{
+    namespace
+    {
+        constexpr char MAGIC[8] = {'P', 'S', 'B', 'I', 'N', 'A', 'R', 'Y'};
+        constexpr uint32_t VERSION = 1;
+
+        typedef StiffnessMatrix::StorageIndex StorageIndex;
+
+        int64_t padded(const int64_t bytes) { return (bytes + 7) / 8 * 8; }
+
+        BinaryHeader make_header(const BinaryHeader::Kind kind)
+        {
+            BinaryHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.kind = kind;
+            return header;
+        }
+
+        bool check_header(const BinaryHeader &header, const BinaryHeader::Kind kind)
+        {
+            return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+                   && header.version == VERSION
+                   && header.kind == kind
+                   && (header.index_size == 4 || header.index_size == 8)
+                   && header.rows >= 0 && header.cols >= 0 && header.nnz >= 0;
+        }
+
+        /// Checks the sizes of the arrays of a sparse matrix header against each other and the file size
+        bool check_sizes(const BinaryHeader &header, const int64_t size)
+        {
+            constexpr int64_t max_index = std::numeric_limits<StorageIndex>::max();
+            if (header.rows > max_index || header.cols >= max_index || header.nnz > max_index)
+                return false;
+            if (header.outer_bytes < 0 || header.inner_bytes < 0 || header.outer_bytes > size || header.inner_bytes > size)
+                return false;
+
+            if (header.flags & BinaryHeader::COMPRESSED)
+            {
+                // At least one byte per column count
+                if (header.outer_bytes < header.cols)
+                    return false;
+            }
+            else if (header.outer_bytes < (header.cols + 1) * header.index_size || header.inner_bytes < header.nnz * header.index_size)
+            {
+                return false;
+            }
+
+            const int64_t values_offset = sizeof(BinaryHeader) + padded(header.outer_bytes) + padded(header.inner_bytes);
+            return values_offset <= size && header.nnz <= (size - values_offset) / int64_t(sizeof(double));
+        }
+
+        /// Checks that the outer index goes from 0 to nnz without decreasing and that the
+        /// inner indices of each column are strictly increasing and below rows
+        template <typename Index>
+        bool check_indices(const int64_t rows, const int64_t cols, const int64_t nnz, const Index *outer, const Index *inner)
+        {
+            if (outer[0] != 0 || outer[cols] != nnz)
+                return false;
+            for (int64_t j = 0; j < cols; ++j)
+            {
+                if (outer[j + 1] < outer[j])
+                    return false;
+                for (int64_t k = outer[j]; k < outer[j + 1]; ++k)
+                {
+                    if (inner[k] < 0 || inner[k] >= rows || (k > outer[j] && inner[k] <= inner[k - 1]))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        // zig-zag + LEB128 varint
+        void encode(int64_t v, std::vector<uint8_t> &out)
+        {
+            uint64_t u = (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+            while (u >= 0x80)
+            {
+                out.push_back(uint8_t(u) | 0x80);
+                u >>= 7;
+            }
+            out.push_back(uint8_t(u));
+        }
+
+        bool decode(const uint8_t *&it, const uint8_t *end, int64_t &v)
+        {
+            uint64_t u = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (it == end)
+                    return false;
+                const uint8_t b = *it++;
+                u |= uint64_t(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                {
+                    v = int64_t(u >> 1) ^ -int64_t(u & 1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void write_block(std::ofstream &out, const void *data, const int64_t bytes)
+        {
+            static const char zeros[8] = {0};
+            out.write(reinterpret_cast<const char *>(data), bytes);
+            out.write(zeros, padded(bytes) - bytes);
+        }
+
+        template <typename Index>
+        void read_indices(const char *data, const int64_t count, StorageIndex *out)
+        {
+            const Index *in = reinterpret_cast<const Index *>(data);
+            for (int64_t i = 0; i < count; ++i)
+                out[i] = StorageIndex(in[i]);
+        }
+
+        bool read_file(const std::string &path, std::vector<int64_t> &buffer, size_t &size)
+        {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in.good())
+                return false;
+            size = size_t(in.tellg());
+            in.seekg(0);
+            buffer.resize((size + 7) / 8);
+            in.read(reinterpret_cast<char *>(buffer.data()), size);
+            return in.good() && size >= sizeof(BinaryHeader);
+        }
+    } // namespace
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void write_binary(const std::string &path, const StiffnessMatrix &A, const bool compress)
+    {
+        if (!A.isCompressed())
+        {
+            StiffnessMatrix tmp = A;
+            tmp.makeCompressed();
+            write_binary(path, tmp, compress);
+            return;
+        }
+
+        BinaryHeader header = make_header(BinaryHeader::SPARSE);
+        header.index_size = sizeof(StorageIndex);
+        header.rows = A.rows();
+        header.cols = A.cols();
+        header.nnz = A.nonZeros();
+
+        std::vector<uint8_t> outer, inner;
+        if (compress)
+        {
+            header.flags |= BinaryHeader::COMPRESSED;
+            outer.reserve(A.outerSize() + 1);
+            inner.reserve(A.nonZeros() * 2);
+            for (Eigen::Index j = 0; j < A.outerSize(); ++j)
+            {
+                const StorageIndex begin = A.outerIndexPtr()[j];
+                const StorageIndex end = A.outerIndexPtr()[j + 1];
+                encode(end - begin, outer);
+
+                int64_t prev = 0;
+                for (StorageIndex k = begin; k < end; ++k)
+                {
+                    encode(A.innerIndexPtr()[k] - prev, inner);
+                    prev = A.innerIndexPtr()[k];
+                }
+            }
+            header.outer_bytes = outer.size();
+            header.inner_bytes = inner.size();
+        }
+        else
+        {
+            header.outer_bytes = (A.outerSize() + 1) * sizeof(StorageIndex);
+            header.inner_bytes = A.nonZeros() * sizeof(StorageIndex);
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out.good())
+            throw std::runtime_error("Unable to open " + path + " for writing");
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        if (compress)
+        {
+            write_block(out, outer.data(), header.outer_bytes);
+            write_block(out, inner.data(), header.inner_bytes);
+        }
+        else
+        {
+            write_block(out, A.outerIndexPtr(), header.outer_bytes);
+            write_block(out, A.innerIndexPtr(), header.inner_bytes);
+        }
+        write_block(out, A.valuePtr(), header.nnz * sizeof(double));
+
+        if (!out.good())
+            throw std::runtime_error("Error while writing " + path);
+    }
+
+    void write_binary(const std::string &path, const Eigen::VectorXd &v)
+    {
+        BinaryHeader header = make_header(BinaryHeader::VECTOR);
+        header.index_size = sizeof(StorageIndex);
+        header.rows = v.size();
+        header.cols = 1;
+        header.nnz = v.size();
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out.good())
+            throw std::runtime_error("Unable to open " + path + " for writing");
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        write_block(out, v.data(), header.nnz * sizeof(double));
+
+        if (!out.good())
+            throw std::runtime_error("Error while writing " + path);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    bool read_binary(const std::string &path, StiffnessMatrix &A)
+    {
+        std::vector<int64_t> buffer;
+        size_t size;
+        if (!read_file(path, buffer, size))
+            return false;
+
+        const char *data = reinterpret_cast<const char *>(buffer.data());
+        const BinaryHeader &header = *reinterpret_cast<const BinaryHeader *>(data);
+        if (!check_header(header, BinaryHeader::SPARSE))
+            return false;
+
+        if (!check_sizes(header, size))
+            return false;
+
+        const int64_t outer_offset = sizeof(BinaryHeader);
+        const int64_t inner_offset = outer_offset + padded(header.outer_bytes);
+        const int64_t value_offset = inner_offset + padded(header.inner_bytes);
+
+        A.resize(header.rows, header.cols);
+        A.resizeNonZeros(header.nnz);
+
+        if (header.flags & BinaryHeader::COMPRESSED)
+        {
+            const uint8_t *outer = reinterpret_cast<const uint8_t *>(data + outer_offset);
+            const uint8_t *outer_end = outer + header.outer_bytes;
+            const uint8_t *inner = reinterpret_cast<const uint8_t *>(data + inner_offset);
+            const uint8_t *inner_end = inner + header.inner_bytes;
+
+            A.outerIndexPtr()[0] = 0;
+            for (int64_t j = 0; j < header.cols; ++j)
+            {
+                int64_t count;
+                if (!decode(outer, outer_end, count))
+                    return false;
+                const int64_t begin = A.outerIndexPtr()[j];
+                if (count < 0 || begin + count > header.nnz)
+                    return false;
+                A.outerIndexPtr()[j + 1] = StorageIndex(begin + count);
+
+                int64_t prev = 0;
+                for (int64_t k = begin; k < begin + count; ++k)
+                {
+                    int64_t delta;
+                    if (!decode(inner, inner_end, delta))
+                        return false;
+                    // Strictly increasing rows, the first delta is the row itself
+                    if ((k > begin ? delta <= 0 : delta < 0) || delta >= header.rows - prev)
+                        return false;
+                    prev += delta;
+                    A.innerIndexPtr()[k] = StorageIndex(prev);
+                }
+            }
+            if (A.outerIndexPtr()[header.cols] != header.nnz)
+                return false;
+        }
+        else
+        {
+            // Validated before the conversion, 64 bits indices could be truncated
+            if (header.index_size == 4)
+            {
+                const int32_t *outer = reinterpret_cast<const int32_t *>(data + outer_offset);
+                const int32_t *inner = reinterpret_cast<const int32_t *>(data + inner_offset);
+                if (!check_indices(header.rows, header.cols, header.nnz, outer, inner))
+                    return false;
+                read_indices<int32_t>(data + outer_offset, header.cols + 1, A.outerIndexPtr());
+                read_indices<int32_t>(data + inner_offset, header.nnz, A.innerIndexPtr());
+            }
+            else
+            {
+                const int64_t *outer = reinterpret_cast<const int64_t *>(data + outer_offset);
+                const int64_t *inner = reinterpret_cast<const int64_t *>(data + inner_offset);
+                if (!check_indices(header.rows, header.cols, header.nnz, outer, inner))
+                    return false;
+                read_indices<int64_t>(data + outer_offset, header.cols + 1, A.outerIndexPtr());
+                read_indices<int64_t>(data + inner_offset, header.nnz, A.innerIndexPtr());
+            }
+        }
+
+        std::memcpy(A.valuePtr(), data + value_offset, header.nnz * sizeof(double));
+        return true;
+    }
+
+    bool read_binary(const std::string &path, Eigen::VectorXd &v)
+    {
+        std::vector<int64_t> buffer;
+        size_t size;
+        if (!read_file(path, buffer, size))
+            return false;
+
+        const char *data = reinterpret_cast<const char *>(buffer.data());
+        const BinaryHeader &header = *reinterpret_cast<const BinaryHeader *>(data);
+        if (!check_header(header, BinaryHeader::VECTOR))
+            return false;
+        if (header.rows != header.nnz || header.nnz > int64_t((size - sizeof(BinaryHeader)) / sizeof(double)))
+            return false;
+
+        v.resize(header.rows);
+        std::memcpy(v.data(), data + sizeof(BinaryHeader), header.rows * sizeof(double));
+        return true;
+    }
+
+    bool convert_market_to_binary(const std::string &mtx_path, const std::string &bin_path, const bool compress)
+    {
+        StiffnessMatrix A;
+        if (!Eigen::loadMarket(A, mtx_path))
+            return false;
+        A.makeCompressed();
+        write_binary(bin_path, A, compress);
+        return true;
+    }
+
+    void save_matrix(const std::string &path, const StiffnessMatrix &A)
+    {
+        const size_t dot = path.find_last_of('.');
+        const std::string ext = dot == std::string::npos ? "" : path.substr(dot);
+        if (ext == ".mtx" || ext == ".mat")
+            Eigen::saveMarket(A, path);
+        else
+            write_binary(path, A);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    MappedBinaryMatrix::MappedBinaryMatrix(const std::string &path)
+    {
+#ifdef _WIN32
+        if (!read_file(path, m_buffer, m_size))
+            throw std::runtime_error("Unable to read " + path);
+        m_data = reinterpret_cast<char *>(m_buffer.data());
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Unable to open " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(BinaryHeader))
+        {
+            ::close(fd);
+            throw std::runtime_error("Invalid binary matrix " + path);
+        }
+        m_size = size_t(st.st_size);
+
+        // Private mapping: writes through the map are copy-on-write
+        void *ptr = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED)
+            throw std::runtime_error("Unable to map " + path);
+        m_data = static_cast<char *>(ptr);
+#endif
+
+        const BinaryHeader &h = header();
+        std::string error;
+        if (!check_header(h, BinaryHeader::SPARSE) || !check_sizes(h, m_size))
+            error = "Invalid binary matrix " + path;
+        else if (h.flags & BinaryHeader::COMPRESSED)
+            error = "Compressed binary matrix " + path + " cannot be mapped, use read_binary";
+        else if (h.index_size != sizeof(StorageIndex))
+            error = "Binary matrix " + path + " has " + std::to_string(h.index_size) + " bytes indices, use read_binary";
+        else
+        {
+            const StorageIndex *outer = reinterpret_cast<const StorageIndex *>(m_data + sizeof(BinaryHeader));
+            const StorageIndex *inner = reinterpret_cast<const StorageIndex *>(m_data + sizeof(BinaryHeader) + padded(h.outer_bytes));
+            if (!check_indices(h.rows, h.cols, h.nnz, outer, inner))
+                error = "Invalid indices in binary matrix " + path;
+        }
+
+        if (!error.empty())
+        {
+#ifndef _WIN32
+            ::munmap(m_data, m_size);
+#endif
+            throw std::runtime_error(error);
+        }
+    }
+
+    MappedBinaryMatrix::~MappedBinaryMatrix()
+    {
+#ifndef _WIN32
+        if (m_data)
+            ::munmap(m_data, m_size);
+#endif
+    }
+
+    Eigen::Map<StiffnessMatrix> MappedBinaryMatrix::matrix()
+    {
+        const BinaryHeader &h = header();
+        char *outer = m_data + sizeof(BinaryHeader);
+        char *inner = outer + padded(h.outer_bytes);
+        char *values = inner + padded(h.inner_bytes);
+
+        return Eigen::Map<StiffnessMatrix>(
+            h.rows, h.cols, h.nnz,
+            reinterpret_cast<StorageIndex *>(outer),
+            reinterpret_cast<StorageIndex *>(inner),
+            reinterpret_cast<double *>(values));
+    }
+
+} // namespace polysolve
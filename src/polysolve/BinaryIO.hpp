@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Compact binary format for sparse matrices and vectors.
+//
+// A file is a 64 bytes header followed by 8 bytes aligned arrays:
+// - sparse matrix: outer index (cols + 1), inner index (nnz), values (nnz),
+//   i.e., the compressed column storage of a StiffnessMatrix;
+// - vector: values (rows).
+// All data is stored in native (little-endian) byte order. When compressed,
+// the outer index is stored as column counts and the inner index as
+// per-column differences, both varint encoded; values are always stored raw.
+////////////////////////////////////////////////////////////////////////////////
+
+namespace polysolve
+{
+    struct BinaryHeader
+    {
+        enum Kind : uint32_t
+        {
+            SPARSE = 1,
+            VECTOR = 2,
+        };
+
+        enum Flags : uint32_t
+        {
+            COMPRESSED = 1,
+        };
+
+        char magic[8];        // "PSBINARY"
+        uint32_t version;     // format version
+        uint32_t kind;        // Kind
+        uint32_t index_size;  // size in bytes of the stored indices
+        uint32_t flags;       // Flags
+        int64_t rows;         // number of rows
+        int64_t cols;         // number of columns
+        int64_t nnz;          // number of stored values
+        int64_t outer_bytes;  // size of the (possibly compressed) outer index
+        int64_t inner_bytes;  // size of the (possibly compressed) inner index
+    };
+    static_assert(sizeof(BinaryHeader) == 64, "BinaryHeader must be 64 bytes");
+
+    /// Writes a compressed sparse matrix, compress enables the varint encoding of the indices
+    void write_binary(const std::string &path, const StiffnessMatrix &A, const bool compress = false);
+
+    /// Writes a dense vector
+    void write_binary(const std::string &path, const Eigen::VectorXd &v);
+
+    /// Reads a sparse matrix into A (any index size and compression), returns false on failure
+    bool read_binary(const std::string &path, StiffnessMatrix &A);
+
+    /// Reads a dense vector into v, returns false on failure
+    bool read_binary(const std::string &path, Eigen::VectorXd &v);
+
+    /// Converts a Matrix Market file to the binary format, returns false on failure
+    bool convert_market_to_binary(const std::string &mtx_path, const std::string &bin_path, const bool compress = false);
+
+    /// Writes A either as Matrix Market (.mtx and .mat extensions) or in the binary format
+    void save_matrix(const std::string &path, const StiffnessMatrix &A);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Raw stream helpers, used by the checkpoints of the nonlinear solvers.
+    // A failed or inconsistent read sets the failbit of the stream.
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Writes a trivially copyable value
+    template <typename T>
+    void write_value(std::ostream &out, const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "write_value needs a trivially copyable type");
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /// Reads a trivially copyable value
+    template <typename T>
+    void read_value(std::istream &in, T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "read_value needs a trivially copyable type");
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    /// Writes a string as its length followed by its characters
+    inline void write_value(std::ostream &out, const std::string &value)
+    {
+        write_value(out, int64_t(value.size()));
+        out.write(value.data(), value.size());
+    }
+
+    inline void read_value(std::istream &in, std::string &value)
+    {
+        int64_t size = -1;
+        read_value(in, size);
+        if (!in || size < 0)
+        {
+            in.setstate(std::ios::failbit);
+            return;
+        }
+        value.resize(size);
+        in.read(value.data(), size);
+    }
+
+    /// Writes a dense matrix or vector as rows, cols, and its column major coefficients
+    template <typename Derived>
+    void write_dense(std::ostream &out, const Eigen::PlainObjectBase<Derived> &m)
+    {
+        write_value(out, int64_t(m.rows()));
+        write_value(out, int64_t(m.cols()));
+        out.write(reinterpret_cast<const char *>(m.data()), m.size() * sizeof(typename Derived::Scalar));
+    }
+
+    /// Reads a dense matrix or vector written by write_dense, resizing m
+    template <typename Derived>
+    void read_dense(std::istream &in, Eigen::PlainObjectBase<Derived> &m)
+    {
+        int64_t rows = -1, cols = -1;
+        read_value(in, rows);
+        read_value(in, cols);
+        if (!in || rows < 0 || cols < 0
+            || (Derived::RowsAtCompileTime != Eigen::Dynamic && rows != Derived::RowsAtCompileTime)
+            || (Derived::ColsAtCompileTime != Eigen::Dynamic && cols != Derived::ColsAtCompileTime))
+        {
+            in.setstate(std::ios::failbit);
+            return;
+        }
+        m.resize(rows, cols);
+        in.read(reinterpret_cast<char *>(m.data()), m.size() * sizeof(typename Derived::Scalar));
+    }
+
+    ///
+    /// @brief      Zero-copy reader for uncompressed binary sparse matrices.
+    ///             The file is memory mapped (copy-on-write) and the returned
+    ///             map points directly to the mapped arrays, so it is only
+    ///             valid while this object is alive. Modifying the map never
+    ///             modifies the file.
+    ///
+    class MappedBinaryMatrix
+    {
+    public:
+        /// Maps path, throws if the file is not an uncompressed sparse matrix
+        /// with the index type of StiffnessMatrix
+        explicit MappedBinaryMatrix(const std::string &path);
+        ~MappedBinaryMatrix();
+
+        MappedBinaryMatrix(MappedBinaryMatrix &&) = delete;
+        MappedBinaryMatrix &operator=(MappedBinaryMatrix &&) = delete;
+        MappedBinaryMatrix(const MappedBinaryMatrix &) = delete;
+        MappedBinaryMatrix &operator=(const MappedBinaryMatrix &) = delete;
+
+        /// Map to the mapped matrix
+        Eigen::Map<StiffnessMatrix> matrix();
+
+        const BinaryHeader &header() const { return *reinterpret_cast<const BinaryHeader *>(m_data); }
+
+    private:
+        char *m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        std::vector<int64_t> m_buffer; // Windows has no mmap, the file is read instead
+#endif
+    };
+
+} // namespace polysolve
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+
+namespace polysolve
+{
+    /// @brief Cooperative cancellation of a solve from another thread, with an optional deadline.
+    /// The solvers check it between their iterations (nonlinear iterations, line search trials,
+    /// and iterations of the iterative linear solvers) and stop early, keeping their last iterate.
+    class CancellationToken
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        CancellationToken() = default;
+
+        /// @param parent Token whose cancellation also cancels this one
+        explicit CancellationToken(std::shared_ptr<const CancellationToken> parent)
+            : m_parent(std::move(parent))
+        {
+        }
+
+        CancellationToken(const CancellationToken &) = delete;
+        CancellationToken &operator=(const CancellationToken &) = delete;
+
+        /// @brief Request the cancellation, can be called from any thread
+        void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+
+        /// @brief Cancel once the deadline has passed
+        void set_deadline(const clock::time_point deadline)
+        {
+            m_deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+        }
+
+        /// @brief Cancel in the given number of seconds from now
+        void set_timeout(const double seconds)
+        {
+            set_deadline(clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds)));
+        }
+
+        void clear_deadline() { m_deadline.store(NO_DEADLINE, std::memory_order_relaxed); }
+
+        /// @brief Clear the cancellation request and the deadline of this token (not of its parent)
+        void reset()
+        {
+            m_cancelled.store(false, std::memory_order_relaxed);
+            clear_deadline();
+        }
+
+        void set_parent(std::shared_ptr<const CancellationToken> parent) { m_parent = std::move(parent); }
+
+        /// @brief True if cancel was called on this token or one of its parents
+        bool cancel_requested() const
+        {
+            return m_cancelled.load(std::memory_order_relaxed) || (m_parent && m_parent->cancel_requested());
+        }
+
+        /// @brief True if the deadline of this token or of one of its parents has passed
+        bool deadline_passed() const
+        {
+            const clock::rep deadline = m_deadline.load(std::memory_order_relaxed);
+            return (deadline != NO_DEADLINE && clock::now().time_since_epoch().count() >= deadline)
+                   || (m_parent && m_parent->deadline_passed());
+        }
+
+        /// @brief True if the solve should stop
+        bool is_cancelled() const { return cancel_requested() || deadline_passed(); }
+
+    private:
+        static constexpr clock::rep NO_DEADLINE = std::numeric_limits<clock::rep>::max();
+
+        std::atomic<bool> m_cancelled{false};
+        std::atomic<clock::rep> m_deadline{NO_DEADLINE};
+        std::shared_ptr<const CancellationToken> m_parent;
+    };
+} // namespace polysolve
@@ -0,0 +1,247 @@
+#include "PerfCounters.hpp"
+
+#include <chrono>
+
+#if defined(POLYSOLVE_WITH_PERF_COUNTERS) && defined(__linux__)
+#define POLYSOLVE_PERF_EVENT_OPEN
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace polysolve::perf
+{
+    namespace
+    {
+        constexpr const char *EVENT_NAMES[N_EVENTS] = {"cycles", "instructions", "cache_references", "cache_misses"};
+
+        constexpr double CACHE_LINE_BYTES = 64;
+
+        /// Group of counters of one thread, opened on first use
+        class CounterGroup
+        {
+        public:
+            ~CounterGroup()
+            {
+#ifdef POLYSOLVE_PERF_EVENT_OPEN
+                for (const int fd : fds)
+                    if (fd >= 0)
+                        close(fd);
+#endif
+            }
+
+            bool open()
+            {
+                if (tried)
+                    return n_opened > 0;
+                tried = true;
+
+#ifdef POLYSOLVE_PERF_EVENT_OPEN
+                constexpr uint64_t configs[N_EVENTS] = {
+                    PERF_COUNT_HW_CPU_CYCLES,
+                    PERF_COUNT_HW_INSTRUCTIONS,
+                    PERF_COUNT_HW_CACHE_REFERENCES,
+                    PERF_COUNT_HW_CACHE_MISSES};
+
+                int leader = -1;
+                for (int e = 0; e < N_EVENTS; ++e)
+                {
+                    perf_event_attr attr{};
+                    attr.size = sizeof(attr);
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.config = configs[e];
+                    attr.disabled = leader < 0;
+                    // User space only, allowed with the default perf_event_paranoid = 2
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv = 1;
+                    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                    // Calling thread on any CPU
+                    fds[e] = int(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+                    if (fds[e] < 0)
+                        continue; // e.g., no cache events in a VM
+                    if (leader < 0)
+                        leader = fds[e];
+                    order[n_opened++] = Event(e);
+                }
+
+                if (leader < 0)
+                    return false;
+
+                ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+                this->leader = leader;
+#endif
+                return n_opened > 0;
+            }
+
+            void read(Sample &sample) const
+            {
+#ifdef POLYSOLVE_PERF_EVENT_OPEN
+                struct
+                {
+                    uint64_t nr;
+                    uint64_t time_enabled;
+                    uint64_t time_running;
+                    uint64_t values[N_EVENTS];
+                } data;
+
+                if (leader < 0 || ::read(leader, &data, sizeof(data)) <= 0)
+                    return;
+
+                // Counts are extrapolated when the PMU is multiplexed between groups
+                const double scale = data.time_running > 0 && data.time_running < data.time_enabled
+                                         ? double(data.time_enabled) / data.time_running
+                                         : 1;
+                for (int i = 0; i < n_opened && i < int(data.nr); ++i)
+                    sample.values[order[i]] = uint64_t(data.values[i] * scale);
+#endif
+            }
+
+            bool is_open(const Event e) const
+            {
+                return fds[e] >= 0;
+            }
+
+        private:
+            std::array<int, N_EVENTS> fds = {-1, -1, -1, -1};
+            std::array<Event, N_EVENTS> order{}; ///< Event of each value of a group read
+            int n_opened = 0;
+            int leader = -1;
+            bool tried = false;
+        };
+
+        CounterGroup &counter_group()
+        {
+            thread_local CounterGroup group;
+            return group;
+        }
+
+        Phases &thread_phases()
+        {
+            thread_local Phases phases;
+            return phases;
+        }
+
+        double seconds()
+        {
+            static const auto epoch = std::chrono::steady_clock::now();
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+        }
+    } // namespace
+
+    namespace internal
+    {
+        Sample read()
+        {
+            Sample sample;
+            counter_group().read(sample);
+            sample.time = seconds();
+            return sample;
+        }
+
+        void accumulate(const char *name, const Sample &begin, const Sample &end)
+        {
+            Counters &c = thread_phases()[name];
+            ++c.count;
+            c.time += end.time - begin.time;
+            for (int e = 0; e < N_EVENTS; ++e)
+                c.values[e] += end.values[e] >= begin.values[e] ? end.values[e] - begin.values[e] : 0;
+        }
+    } // namespace internal
+
+    void enable(const bool value)
+    {
+        if (value)
+            counter_group().open();
+        internal::enabled = value;
+    }
+
+    bool available()
+    {
+        return counter_group().open();
+    }
+
+    void clear()
+    {
+        thread_phases().clear();
+    }
+
+    const Phases &phases()
+    {
+        return thread_phases();
+    }
+
+    Phases difference(const Phases &after, const Phases &before)
+    {
+        Phases res;
+        for (const auto &[name, a] : after)
+        {
+            const auto it = before.find(name);
+            if (it == before.end())
+            {
+                res[name] = a;
+                continue;
+            }
+
+            const Counters &b = it->second;
+            if (a.count == b.count)
+                continue;
+
+            Counters &c = res[name];
+            c.count = a.count - b.count;
+            c.time = a.time - b.time;
+            for (int e = 0; e < N_EVENTS; ++e)
+                c.values[e] = a.values[e] - b.values[e];
+        }
+        return res;
+    }
+
+    json to_json(const Phases &phases)
+    {
+        const CounterGroup &group = counter_group();
+
+        json res = json::object();
+        for (const auto &[name, c] : phases)
+        {
+            json p;
+            p["count"] = c.count;
+            p["time"] = c.time;
+            for (int e = 0; e < N_EVENTS; ++e)
+            {
+                if (group.is_open(Event(e)))
+                    p[EVENT_NAMES[e]] = c.values[e];
+            }
+
+            const double cycles = c.values[CYCLES];
+            if (cycles > 0 && group.is_open(INSTRUCTIONS))
+                p["instructions_per_cycle"] = c.values[INSTRUCTIONS] / cycles;
+            if (c.time > 0 && group.is_open(CYCLES))
+                p["GHz"] = cycles / c.time * 1e-9;
+            if (c.values[CACHE_REFERENCES] > 0 && group.is_open(CACHE_MISSES))
+                p["cache_miss_rate"] = double(c.values[CACHE_MISSES]) / c.values[CACHE_REFERENCES];
+            if (c.time > 0 && group.is_open(CACHE_MISSES))
+                p["bandwidth_GBps"] = c.values[CACHE_MISSES] * CACHE_LINE_BYTES / c.time * 1e-9;
+
+            res[name] = p;
+        }
+        return res;
+    }
+
+    Region::Region()
+        : m_was_enabled(is_enabled()), m_before(phases())
+    {
+        enable(true);
+    }
+
+    Region::~Region()
+    {
+        enable(m_was_enabled);
+    }
+
+    json Region::report() const
+    {
+        return to_json(difference(phases(), m_before));
+    }
+} // namespace polysolve::perf
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Hardware performance counters (Linux perf_event_open) accumulated per named
+// phase: every StopWatch and traced scope of the calling thread adds its cycles,
+// instructions and last-level cache traffic while counting is enabled on that
+// thread. Without counter access (non-Linux, perf_event_paranoid, containers)
+// only the times and call counts are accumulated.
+////////////////////////////////////////////////////////////////////////////////
+
+#define POLYSOLVE_PERF_CONCAT_IMPL(a, b) a##b
+#define POLYSOLVE_PERF_CONCAT(a, b) POLYSOLVE_PERF_CONCAT_IMPL(a, b)
+
+#ifdef POLYSOLVE_WITH_PERF_COUNTERS
+/// Counts the events of the enclosing scope, name has to be a string literal
+#define POLYSOLVE_PERF_SCOPE(name) \
+    polysolve::perf::Scope POLYSOLVE_PERF_CONCAT(__polysolve_perf_scope_, __LINE__)("" name "")
+#else
+#define POLYSOLVE_PERF_SCOPE(name) (void)0
+#endif
+
+namespace polysolve::perf
+{
+    enum Event
+    {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        CACHE_REFERENCES, ///< Last-level cache accesses
+        CACHE_MISSES,     ///< Last-level cache misses
+        N_EVENTS
+    };
+
+    /// @brief Counter values at one point in time
+    struct Sample
+    {
+        double time = 0; ///< Seconds
+        std::array<uint64_t, N_EVENTS> values{};
+    };
+
+    /// @brief Events accumulated over every call of a phase
+    struct Counters
+    {
+        size_t count = 0;
+        double time = 0;
+        std::array<uint64_t, N_EVENTS> values{};
+    };
+
+    using Phases = std::map<std::string, Counters>;
+
+    namespace internal
+    {
+        inline thread_local bool enabled = false;
+
+        /// Current values of the counters of the calling thread
+        Sample read();
+
+        /// Adds end - begin to the phase name of the calling thread
+        void accumulate(const char *name, const Sample &begin, const Sample &end);
+    } // namespace internal
+
+    /// @brief Start or stop counting on the calling thread
+    void enable(const bool value = true);
+
+    inline bool is_enabled() { return internal::enabled; }
+
+    /// @brief True if the hardware counters could be opened on the calling thread
+    bool available();
+
+    /// @brief Drop the phases of the calling thread
+    void clear();
+
+    /// @brief Phases accumulated by the calling thread
+    const Phases &phases();
+
+    /// @brief Events of after which are not in before, e.g., over one solve
+    Phases difference(const Phases &after, const Phases &before);
+
+    /// @brief Phases with their raw counts and derived metrics: instructions per
+    /// cycle, clock frequency, LLC miss rate, and DRAM bandwidth estimated from
+    /// the LLC misses (one 64-byte line each)
+    json to_json(const Phases &phases);
+
+    /// @brief Counts the events between its construction and destruction
+    class Scope
+    {
+    public:
+        explicit Scope(const char *name)
+            : m_name(is_enabled() ? name : nullptr)
+        {
+            if (m_name)
+                m_begin = internal::read();
+        }
+
+        ~Scope()
+        {
+            if (m_name)
+                internal::accumulate(m_name, m_begin, internal::read());
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const char *m_name;
+        Sample m_begin;
+    };
+
+    /// @brief Enables counting on the calling thread during its lifetime and
+    /// reports the phases counted meanwhile
+    class Region
+    {
+    public:
+        Region();
+        ~Region();
+
+        Region(const Region &) = delete;
+        Region &operator=(const Region &) = delete;
+
+        json report() const;
+
+    private:
+        bool m_was_enabled;
+        Phases m_before;
+    };
+} // namespace polysolve::perf
@@ -0,0 +1,184 @@
+#include "Tracing.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+namespace polysolve::tracing
+{
+    namespace
+    {
+        struct Event
+        {
+            const char *name;
+            int64_t begin;
+            int64_t end;
+        };
+
+        struct ThreadBuffer
+        {
+            std::mutex mutex; ///< Only contended while exporting
+            std::vector<Event> events;
+            size_t dropped = 0;
+            int id;
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers; ///< Kept after their thread exits
+            std::unordered_set<std::string> names;              ///< Interned names, nodes are stable
+            std::atomic<size_t> capacity{size_t(1) << 20};
+            const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        };
+
+        Registry &registry()
+        {
+            static Registry r;
+            return r;
+        }
+
+        ThreadBuffer &thread_buffer()
+        {
+            thread_local ThreadBuffer *buffer = nullptr;
+            if (!buffer)
+            {
+                Registry &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.buffers.push_back(std::make_unique<ThreadBuffer>());
+                buffer = r.buffers.back().get();
+                buffer->id = int(r.buffers.size()) - 1;
+            }
+            return *buffer;
+        }
+    } // namespace
+
+    namespace internal
+    {
+        std::atomic<bool> enabled{false};
+
+        int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - registry().epoch)
+                .count();
+        }
+
+        void record(const char *name, const int64_t begin, const int64_t end)
+        {
+            ThreadBuffer &buffer = thread_buffer();
+            std::lock_guard<std::mutex> lock(buffer.mutex);
+            if (buffer.events.size() >= registry().capacity.load(std::memory_order_relaxed))
+                ++buffer.dropped;
+            else
+                buffer.events.push_back({name, begin, end});
+        }
+    } // namespace internal
+
+    void enable(const bool value)
+    {
+        registry(); // starts the clock
+        internal::enabled.store(value, std::memory_order_relaxed);
+    }
+
+    void set_thread_capacity(const size_t capacity)
+    {
+        registry().capacity = capacity;
+    }
+
+    void clear()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto &buffer : r.buffers)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            buffer->events.clear();
+            buffer->dropped = 0;
+        }
+    }
+
+    size_t size()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        size_t res = 0;
+        for (auto &buffer : r.buffers)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            res += buffer->events.size();
+        }
+        return res;
+    }
+
+    size_t dropped()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        size_t res = 0;
+        for (auto &buffer : r.buffers)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            res += buffer->dropped;
+        }
+        return res;
+    }
+
+    const char *intern(const std::string &name)
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        return r.names.insert(name).first->c_str();
+    }
+
+    json chrome_trace()
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+
+        json events = json::array();
+        std::vector<Event> sorted;
+        for (auto &buffer : r.buffers)
+        {
+            {
+                std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+                sorted = buffer->events;
+            }
+            // Spans are recorded when they end, parents have to come before their children
+            std::sort(sorted.begin(), sorted.end(), [](const Event &a, const Event &b) {
+                return a.begin != b.begin ? a.begin < b.begin : a.end > b.end;
+            });
+
+            for (const Event &e : sorted)
+            {
+                json event;
+                event["name"] = e.name;
+                event["ph"] = "X";
+                event["ts"] = e.begin * 1e-3; // µs
+                event["dur"] = (e.end - e.begin) * 1e-3;
+                event["pid"] = 0;
+                event["tid"] = buffer->id;
+                events.push_back(event);
+            }
+        }
+
+        json res;
+        res["traceEvents"] = events;
+        res["displayTimeUnit"] = "ms";
+        return res;
+    }
+
+    void write_chrome_trace(const std::string &path)
+    {
+        std::ofstream out(path);
+        if (!out.is_open())
+            throw std::runtime_error("Unable to open " + path + " for writing");
+        out << chrome_trace().dump();
+        if (!out)
+            throw std::runtime_error("Error while writing " + path);
+    }
+} // namespace polysolve::tracing
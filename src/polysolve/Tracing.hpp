@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Types.hpp"
+#include "PerfCounters.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Hierarchical tracing of scopes, exported as Chrome trace JSON (chrome://tracing
+// or https://ui.perfetto.dev). Spans are recorded in per-thread buffers only
+// while tracing is enabled at runtime, a disabled span costs one relaxed atomic
+// load. Building without POLYSOLVE_WITH_TRACING removes them entirely.
+////////////////////////////////////////////////////////////////////////////////
+
+#define POLYSOLVE_TRACE_CONCAT_IMPL(a, b) a##b
+#define POLYSOLVE_TRACE_CONCAT(a, b) POLYSOLVE_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef POLYSOLVE_WITH_TRACING
+#define POLYSOLVE_TRACE_SPAN(name) \
+    polysolve::tracing::Span POLYSOLVE_TRACE_CONCAT(__polysolve_trace_span_, __LINE__)("" name "")
+#else
+#define POLYSOLVE_TRACE_SPAN(name) (void)0
+#endif
+
+/// Traces the enclosing scope and counts its hardware events, name has to be a string literal
+#define POLYSOLVE_TRACE_SCOPE(name) \
+    POLYSOLVE_TRACE_SPAN(name);     \
+    POLYSOLVE_PERF_SCOPE(name)
+
+namespace polysolve::tracing
+{
+    namespace internal
+    {
+        extern std::atomic<bool> enabled;
+
+        /// Nanoseconds since the first enable
+        int64_t now();
+
+        /// Appends a span to the buffer of the calling thread
+        void record(const char *name, const int64_t begin, const int64_t end);
+    } // namespace internal
+
+    /// @brief Start or stop recording spans
+    void enable(const bool value = true);
+
+    inline bool is_enabled() { return internal::enabled.load(std::memory_order_relaxed); }
+
+    /// @brief Maximum number of spans kept per thread, the later ones are dropped
+    void set_thread_capacity(const size_t capacity);
+
+    /// @brief Drop the recorded spans of every thread
+    void clear();
+
+    /// @brief Number of recorded spans, and of spans dropped because a buffer was full
+    size_t size();
+    size_t dropped();
+
+    /// @brief Stable copy of a runtime name, for spans whose name is not a literal
+    const char *intern(const std::string &name);
+
+    /// @brief Recorded spans as a Chrome trace ("X" complete events, one tid per thread)
+    json chrome_trace();
+
+    /// @brief Write chrome_trace() to a file
+    void write_chrome_trace(const std::string &path);
+
+    /// @brief Records the time between its construction and destruction
+    class Span
+    {
+    public:
+        explicit Span(const char *name)
+            : m_name(is_enabled() ? name : nullptr)
+        {
+            if (m_name)
+                m_begin = internal::now();
+        }
+
+        ~Span()
+        {
+            if (m_name)
+                internal::record(m_name, m_begin, internal::now());
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *m_name;
+        int64_t m_begin = 0;
+    };
+} // namespace polysolve::tracing
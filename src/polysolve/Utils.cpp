@@ -1,4 +1,5 @@
 #include "Utils.hpp"
+#include "Tracing.hpp"
 
 #if defined(SPDLOG_FMT_EXTERNAL)
 #include <fmt/color.h>
@@ -10,13 +11,13 @@ namespace polysolve
 {
 
     StopWatch::StopWatch(const std::string &name, spdlog::logger &logger)
-        : m_name(name), m_logger(logger)
+        : m_owned_name(name), m_name(m_owned_name.c_str()), m_logger(logger)
     {
         start();
     }
 
     StopWatch::StopWatch(const std::string &name, double &total_time, spdlog::logger &logger)
-        : m_name(name), m_total_time(&total_time), m_logger(logger)
+        : m_owned_name(name), m_name(m_owned_name.c_str()), m_total_time(&total_time), m_logger(logger)
     {
         start();
     }
@@ -29,6 +30,14 @@ namespace polysolve
     void StopWatch::start()
     {
         is_running = true;
+#ifdef POLYSOLVE_WITH_TRACING
+        m_trace_begin = tracing::is_enabled() && m_name[0] != '\0' ? tracing::internal::now() : -1;
+#endif
+#ifdef POLYSOLVE_WITH_PERF_COUNTERS
+        m_perf = perf::is_enabled() && m_name[0] != '\0';
+        if (m_perf)
+            m_perf_begin = perf::internal::read();
+#endif
         m_start = clock::now();
     }
 
@@ -37,6 +46,18 @@ namespace polysolve
         if (!is_running)
             return;
         m_stop = clock::now();
+#ifdef POLYSOLVE_WITH_PERF_COUNTERS
+        if (m_perf)
+            perf::internal::accumulate(m_name, m_perf_begin, perf::internal::read());
+#endif
+#ifdef POLYSOLVE_WITH_TRACING
+        if (m_trace_begin >= 0)
+        {
+            // Runtime names have to outlive the trace
+            const char *name = m_name == m_owned_name.c_str() ? tracing::intern(m_owned_name) : m_name;
+            tracing::internal::record(name, m_trace_begin, tracing::internal::now());
+        }
+#endif
 
         is_running = false;
         log_msg();
@@ -56,7 +77,7 @@ namespace polysolve
         const static auto log_fmt_text =
             fmt::format("[{}] {{}} {{:.3g}}s", fmt::format(fmt::fg(fmt::terminal_color::magenta), "timing"));
 
-        if (!m_name.empty())
+        if (m_name[0] != '\0')
         {
             m_logger.trace(log_fmt_text, m_name, getElapsedTimeInSec());
         }
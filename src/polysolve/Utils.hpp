@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Types.hpp"
+#include "PerfCounters.hpp"
 
 #include <spdlog/spdlog.h>
 
@@ -29,9 +30,27 @@ namespace polysolve
         using clock = std::chrono::steady_clock;
 
     public:
+        /// @brief Literal names are used without copy, and as trace span names (see Tracing.hpp)
+        /// and performance counter phases (see PerfCounters.hpp)
+        template <size_t N>
+        StopWatch(const char (&name)[N], spdlog::logger &logger)
+            : m_name(name), m_logger(logger)
+        {
+            start();
+        }
+        template <size_t N>
+        StopWatch(const char (&name)[N], double &total_time, spdlog::logger &logger)
+            : m_name(name), m_total_time(&total_time), m_logger(logger)
+        {
+            start();
+        }
+
         StopWatch(const std::string &name, spdlog::logger &logger);
         StopWatch(const std::string &name, double &total_time, spdlog::logger &logger);
 
+        StopWatch(const StopWatch &) = delete;
+        StopWatch &operator=(const StopWatch &) = delete;
+
         virtual ~StopWatch();
 
         void start();
@@ -41,8 +60,12 @@ namespace polysolve
         void log_msg();
 
     private:
-        std::string m_name;
+        std::string m_owned_name; ///< Storage of m_name if it is not a literal
+        const char *m_name;
         std::chrono::time_point<clock> m_start, m_stop;
+        int64_t m_trace_begin = -1; ///< Start in the trace clock, -1 if not traced
+        perf::Sample m_perf_begin;
+        bool m_perf = false; ///< Hardware events are counted
         double *m_total_time = nullptr;
         size_t *m_count = nullptr;
         bool is_running = false;
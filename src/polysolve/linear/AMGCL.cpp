@@ -2,6 +2,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "AMGCL.hpp"
+#include <polysolve/Tracing.hpp>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
@@ -141,12 +142,41 @@ namespace polysolve::linear
         }
         params["num_iterations"] = iterations_;
         params["final_res_norm"] = residual_error_;
+        if (solver_)
+            params["precond_bytes"] = solver_->bytes();
+    }
+
+    int AMGCL::iterations() const
+    {
+        if (block_size_ == 2)
+            return block2_solver_.iterations();
+        else if (block_size_ == 3)
+            return block3_solver_.iterations();
+        return iterations_;
+    }
+
+    void AMGCL::set_tolerance(const double tol)
+    {
+        if (block_size_ == 2)
+            block2_solver_.set_tolerance(tol);
+        else if (block_size_ == 3)
+            block3_solver_.set_tolerance(tol);
+        else
+            params_["solver"]["tol"] = tol;
+    }
+
+    void AMGCL::set_cancellation_token(const std::shared_ptr<const CancellationToken> &token)
+    {
+        Solver::set_cancellation_token(token);
+        block2_solver_.set_cancellation_token(token);
+        block3_solver_.set_cancellation_token(token);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
     void AMGCL::factorize(const StiffnessMatrix &Ain)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
         if (block_size_ == 2)
         {
             block2_solver_.factorize(Ain);
@@ -189,6 +219,7 @@ namespace polysolve::linear
 
     void AMGCL::solve(const Eigen::Ref<const VectorXd> rhs, Eigen::Ref<VectorXd> result)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
         if (block_size_ == 2)
         {
             block2_solver_.solve(rhs, result);
@@ -200,6 +231,11 @@ namespace polysolve::linear
             return;
         }
         assert(result.size() == rhs.size());
+        if (is_cancelled())
+        {
+            iterations_ = 0;
+            return;
+        }
         std::vector<double> _rhs(rhs.data(), rhs.data() + rhs.size());
         std::vector<double> x(result.data(), result.data() + result.size());
         auto rhs_b = Backend::copy_vector(_rhs, backend_params_);
@@ -238,6 +274,8 @@ namespace polysolve::linear
     {
         params["num_iterations"] = iterations_;
         params["final_res_norm"] = residual_error_;
+        if (solver_)
+            params["precond_bytes"] = solver_->bytes();
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -282,6 +320,11 @@ namespace polysolve::linear
     void AMGCL_Block<BLOCK_SIZE>::solve(const Eigen::Ref<const VectorXd> rhs, Eigen::Ref<VectorXd> result)
     {
         assert(result.size() == rhs.size());
+        if (is_cancelled())
+        {
+            iterations_ = 0;
+            return;
+        }
         std::vector<double> _rhs(rhs.data(), rhs.data() + rhs.size());
         std::vector<double> x(result.data(), result.data() + result.size());
 
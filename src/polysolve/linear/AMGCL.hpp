@@ -67,12 +67,18 @@ namespace polysolve::linear
         // Retrieve information
         virtual void get_info(json &params) const override;
 
+        // Iterations of the last solve
+        virtual int iterations() const override { return iterations_; }
+
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) override { precond_num_ = precond_num; }
 
         // Factorize system matrix
         virtual void factorize(const StiffnessMatrix &A) override;
 
+        // Set the relative tolerance, used from the next factorize
+        virtual void set_tolerance(const double tol) override { params_["solver"]["tol"] = tol; }
+
         // Solve the linear system Ax = b
         virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override;
 
@@ -116,6 +122,9 @@ namespace polysolve::linear
         // Retrieve information
         virtual void get_info(json &params) const override;
 
+        // Iterations of the last solve
+        virtual int iterations() const override;
+
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) override
         {
@@ -135,6 +144,12 @@ namespace polysolve::linear
         // Factorize system matrix
         virtual void factorize(const StiffnessMatrix &A) override;
 
+        // Set the relative tolerance, used from the next factorize
+        virtual void set_tolerance(const double tol) override;
+
+        // Only checked before each solve, AMGCL runs its iterations in one call
+        virtual void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) override;
+
         // Solve the linear system Ax = b
         virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override;
 
@@ -2,6 +2,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "Solver.hpp"
+
+#include <type_traits>
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace polysolve::linear
@@ -19,6 +21,11 @@ namespace polysolve::linear
         // Name of the solver
         std::string m_Name;
 
+        // Number of nonzeros of the factors, estimated by analyze_pattern and
+        // exact after factorize (negative if the backend does not expose it)
+        int64_t m_EstimatedFactorNnz = -1;
+        int64_t m_FactorNnz = -1;
+
     public:
         // Name of the solver type (for debugging purposes)
         virtual std::string name() const override { return m_Name; }
@@ -33,6 +40,9 @@ namespace polysolve::linear
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &K, const int precond_num) override;
 
+        // Estimated size of the factors
+        virtual int64_t estimated_factor_bytes() const override;
+
         // Factorize system matrix
         virtual void factorize(const StiffnessMatrix &K) override;
 
@@ -52,6 +62,12 @@ namespace polysolve::linear
         // Name of the solver
         std::string m_Name;
 
+        // Iteration limit from the parameters (negative for the default of Eigen)
+        int m_MaxIterations = -1;
+
+        // Iterations of the last solve, over all its chunks when it is cancellable
+        int m_Iterations = 0;
+
     public:
         // Name of the solver type (for debugging purposes)
         virtual std::string name() const override { return m_Name; }
@@ -66,12 +82,18 @@ namespace polysolve::linear
         // Get info on the last solve step
         virtual void get_info(json &params) const override;
 
+        // Iterations of the last solve
+        virtual int iterations() const override { return m_Iterations; }
+
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &K, const int precond_num) override;
 
         // Factorize system matrix
         virtual void factorize(const StiffnessMatrix &K) override;
 
+        // Set the relative tolerance of the next solves
+        virtual void set_tolerance(const double tol) override { m_Solver.setTolerance(tol); }
+
         // Solve the linear system
         virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override;
     };
@@ -80,13 +102,45 @@ namespace polysolve::linear
 
     // -----------------------------------------------------------------------------
 
+    // Maps a dense decomposition to its in-place counterpart (factors stored in
+    // the user matrix through an Eigen::Ref), void if there is none.
+    template <typename DenseSolver>
+    struct InplaceDecomposition
+    {
+        typedef void type;
+    };
+
+    template <>
+    struct InplaceDecomposition<Eigen::LLT<Eigen::MatrixXd>>
+    {
+        typedef Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>> type;
+    };
+
+    template <>
+    struct InplaceDecomposition<Eigen::LDLT<Eigen::MatrixXd>>
+    {
+        typedef Eigen::LDLT<Eigen::Ref<Eigen::MatrixXd>> type;
+    };
+
+    template <>
+    struct InplaceDecomposition<Eigen::PartialPivLU<Eigen::MatrixXd>>
+    {
+        typedef Eigen::PartialPivLU<Eigen::Ref<Eigen::MatrixXd>> type;
+    };
+
     template <typename DenseSolver>
     class EigenDenseSolver : public Solver
     {
     protected:
+        typedef typename InplaceDecomposition<DenseSolver>::type InplaceSolver;
+        static constexpr bool has_inplace = !std::is_void_v<InplaceSolver>;
+
         // Solver class
         DenseSolver m_Solver;
 
+        // In-place solver (constructed on the user matrix, null when m_Solver is used)
+        std::unique_ptr<std::conditional_t<has_inplace, InplaceSolver, DenseSolver>> m_InplaceSolver;
+
         // Name of the solver
         std::string m_Name;
 
@@ -109,6 +163,12 @@ namespace polysolve::linear
         // Factorize system matrix
         virtual void factorize_dense(const Eigen::MatrixXd &K) override;
 
+        // Factorize system matrix reusing its storage
+        virtual void factorize_dense_inplace(Eigen::MatrixXd &K) override;
+
+        // LU factorizations overwrite the whole matrix
+        virtual bool factorize_dense_preserves_upper() const override;
+
         // Solve the linear system
         virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override;
     };
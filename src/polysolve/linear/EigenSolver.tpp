@@ -2,7 +2,10 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "EigenSolver.hpp"
+#include <polysolve/Tracing.hpp>
+#include <algorithm>
 #include <iostream>
+#include <vector>
 ////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -10,6 +13,129 @@
 ////////////////////////////////////////////////////////////////////////////////
 namespace polysolve::linear
 {
+    namespace internal
+    {
+        // Detection of the backends exposing the size of their factors
+
+        template <typename S, typename = void>
+        struct is_cholmod : std::false_type
+        {
+        };
+        template <typename S>
+        struct is_cholmod<S, std::void_t<decltype(std::declval<S &>().cholmod().lnz)>> : std::true_type
+        {
+        };
+
+        template <typename S, typename = void>
+        struct is_simplicial : std::false_type
+        {
+        };
+        template <typename S>
+        struct is_simplicial<S, std::void_t<decltype(std::declval<const S &>().matrixL().nestedExpression().nonZeros()),
+                                            decltype(std::declval<const S &>().permutationP())>> : std::true_type
+        {
+        };
+
+        template <typename S, typename = void>
+        struct has_vector_d : std::false_type
+        {
+        };
+        template <typename S>
+        struct has_vector_d<S, std::void_t<decltype(std::declval<const S &>().vectorD())>> : std::true_type
+        {
+        };
+
+        template <typename S, typename = void>
+        struct is_sparse_lu : std::false_type
+        {
+        };
+        template <typename S>
+        struct is_sparse_lu<S, std::void_t<decltype(std::declval<const S &>().nnzL()),
+                                           decltype(std::declval<const S &>().nnzU())>> : std::true_type
+        {
+        };
+
+        template <typename S, typename = void>
+        struct is_mkl_pardiso : std::false_type
+        {
+        };
+        template <typename S>
+        struct is_mkl_pardiso<S, std::void_t<decltype(std::declval<S &>().pardisoParameterArray())>> : std::true_type
+        {
+        };
+
+        // Number of nonzeros of the Cholesky factor of P A P^T (A with a
+        // symmetric pattern), computed with the elimination tree as in Eigen's
+        // SimplicialCholeskyBase::analyzePattern_preordered.
+        template <typename Permutation>
+        int64_t cholesky_factor_nnz(const StiffnessMatrix &A, const Permutation &P)
+        {
+            typedef StiffnessMatrix::StorageIndex StorageIndex;
+            const StorageIndex n = A.cols();
+            const bool has_perm = P.size() == n;
+            Eigen::Matrix<StorageIndex, Eigen::Dynamic, 1> pinv(n);
+            for (StorageIndex i = 0; i < n; ++i)
+                pinv[has_perm ? P.indices()[i] : i] = i;
+
+            std::vector<StorageIndex> parent(n), tags(n);
+            int64_t nnz = n; // diagonal
+            for (StorageIndex k = 0; k < n; ++k)
+            {
+                parent[k] = -1;
+                tags[k] = k;
+                for (StiffnessMatrix::InnerIterator it(A, pinv[k]); it; ++it)
+                {
+                    StorageIndex i = has_perm ? P.indices()[it.index()] : StorageIndex(it.index());
+                    if (i >= k)
+                        continue;
+                    for (; tags[i] != k; i = parent[i])
+                    {
+                        if (parent[i] == -1)
+                            parent[i] = k;
+                        ++nnz;
+                        tags[i] = k;
+                    }
+                }
+            }
+            return nnz;
+        }
+
+        // Estimated number of nonzeros of the factors after the symbolic analysis
+        template <typename S>
+        int64_t estimated_factor_nnz(S &solver, const StiffnessMatrix &A)
+        {
+            if constexpr (is_cholmod<S>::value)
+                return int64_t(solver.cholmod().lnz);
+            else if constexpr (is_simplicial<S>::value)
+                return cholesky_factor_nnz(A, solver.permutationP());
+            else if constexpr (is_mkl_pardiso<S>::value)
+                return solver.pardisoParameterArray()[17];
+            else
+                return -1;
+        }
+
+        // Number of nonzeros of the factors after the numerical factorization
+        template <typename S>
+        int64_t factor_nnz(S &solver)
+        {
+            if constexpr (is_cholmod<S>::value)
+                return int64_t(solver.cholmod().lnz);
+            else if constexpr (is_simplicial<S>::value)
+                return solver.matrixL().nestedExpression().nonZeros() + (has_vector_d<S>::value ? solver.rows() : 0);
+            else if constexpr (is_sparse_lu<S>::value)
+                return int64_t(solver.nnzL()) + int64_t(solver.nnzU());
+            else if constexpr (is_mkl_pardiso<S>::value)
+                return solver.pardisoParameterArray()[17];
+            else
+                return -1;
+        }
+
+        inline int64_t factor_bytes(const int64_t nnz)
+        {
+            return nnz * int64_t(sizeof(double) + sizeof(StiffnessMatrix::StorageIndex));
+        }
+    } // namespace internal
+
     // Get info on the last solve step
     template <typename SparseSolver>
     void EigenDirect<SparseSolver>::get_info(json &params) const
@@ -31,24 +157,41 @@ namespace polysolve::linear
         default:
             assert(false);
         }
+
+        if (m_FactorNnz >= 0)
+        {
+            params["factor_nnz"] = m_FactorNnz;
+            params["factor_bytes"] = internal::factor_bytes(m_FactorNnz);
+        }
     }
 
     // Analyze sparsity pattern
     template <typename SparseSolver>
     void EigenDirect<SparseSolver>::analyze_pattern(const StiffnessMatrix &A, const int precond_num)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: analyze_pattern");
         m_Solver.analyzePattern(A);
+        m_EstimatedFactorNnz = internal::estimated_factor_nnz(m_Solver, A);
+        m_FactorNnz = -1;
+    }
+
+    template <typename SparseSolver>
+    int64_t EigenDirect<SparseSolver>::estimated_factor_bytes() const
+    {
+        return m_EstimatedFactorNnz >= 0 ? internal::factor_bytes(m_EstimatedFactorNnz) : -1;
     }
 
     // Factorize system matrix
     template <typename SparseSolver>
     void EigenDirect<SparseSolver>::factorize(const StiffnessMatrix &A)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
         m_Solver.factorize(A);
         if (m_Solver.info() == Eigen::NumericalIssue)
         {
             throw std::runtime_error("[EigenDirect] NumericalIssue encountered.");
         }
+        m_FactorNnz = m_Solver.info() == Eigen::Success ? internal::factor_nnz(m_Solver) : -1;
     }
 
     // Solve the linear system
@@ -56,6 +199,7 @@ namespace polysolve::linear
     void EigenDirect<SparseSolver>::solve(
         const Ref<const VectorXd> b, Ref<VectorXd> x)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
         x = m_Solver.solve(b);
     }
 
@@ -72,7 +216,8 @@ namespace polysolve::linear
         {
             if (params[solver_name].contains("max_iter"))
             {
-                m_Solver.setMaxIterations(params[solver_name]["max_iter"]);
+                m_MaxIterations = params[solver_name]["max_iter"];
+                m_Solver.setMaxIterations(m_MaxIterations);
             }
             if (params[solver_name].contains("tolerance"))
             {
@@ -85,7 +230,7 @@ namespace polysolve::linear
     template <typename SparseSolver>
     void EigenIterative<SparseSolver>::get_info(json &params) const
     {
-        params["solver_iter"] = m_Solver.iterations();
+        params["solver_iter"] = m_Iterations;
         params["solver_error"] = m_Solver.error();
     }
 
@@ -93,6 +238,7 @@ namespace polysolve::linear
     template <typename SparseSolver>
     void EigenIterative<SparseSolver>::analyze_pattern(const StiffnessMatrix &A, const int precond_num)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: analyze_pattern");
         m_Solver.analyzePattern(A);
     }
 
@@ -100,6 +246,7 @@ namespace polysolve::linear
     template <typename SparseSolver>
     void EigenIterative<SparseSolver>::factorize(const StiffnessMatrix &A)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
         m_Solver.factorize(A);
     }
 
@@ -108,8 +255,27 @@ namespace polysolve::linear
     void EigenIterative<SparseSolver>::solve(
         const Ref<const VectorXd> b, Ref<VectorXd> x)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
         assert(x.size() == b.size());
-        x = m_Solver.solveWithGuess(b, x);
+        if (!m_cancellation)
+        {
+            x = m_Solver.solveWithGuess(b, x);
+            m_Iterations = m_Solver.iterations();
+            return;
+        }
+
+        // Solve in growing chunks restarted from the current iterate, to check the token in between
+        const int max_iterations = m_Solver.maxIterations();
+        int chunk = CANCELLATION_CHECK_INTERVAL;
+        m_Iterations = 0;
+        do
+        {
+            m_Solver.setMaxIterations(std::min(chunk, max_iterations - m_Iterations));
+            x = m_Solver.solveWithGuess(b, x);
+            m_Iterations += m_Solver.iterations();
+            chunk *= 2;
+        } while (m_Solver.info() == Eigen::NoConvergence && m_Iterations < max_iterations && !is_cancelled());
+        m_Solver.setMaxIterations(m_MaxIterations);
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -121,6 +287,11 @@ namespace polysolve::linear
     void EigenDenseSolver<DenseSolver>::get_info(json &params) const
     {
         params["solver_info"] = "Success";
+
+        const int64_t n = m_InplaceSolver ? m_InplaceSolver->rows() : m_Solver.rows();
+        params["factor_nnz"] = n * n;
+        params["factor_bytes"] = n * n * int64_t(sizeof(double));
+        params["factor_inplace"] = bool(m_InplaceSolver);
     }
 
     template <typename DenseSolver>
@@ -133,14 +304,44 @@ namespace polysolve::linear
     template <typename DenseSolver>
     void EigenDenseSolver<DenseSolver>::factorize_dense(const Eigen::MatrixXd &A)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
+        m_InplaceSolver.reset();
         m_Solver.compute(A);
     }
 
+    // Factorize system matrix reusing its storage
+    template <typename DenseSolver>
+    void EigenDenseSolver<DenseSolver>::factorize_dense_inplace(Eigen::MatrixXd &A)
+    {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
+        if constexpr (has_inplace)
+        {
+            // Release the previous factors before computing the new ones
+            m_Solver = DenseSolver();
+            m_InplaceSolver = std::make_unique<InplaceSolver>(A);
+        }
+        else
+        {
+            factorize_dense(A);
+        }
+    }
+
+    template <typename DenseSolver>
+    bool EigenDenseSolver<DenseSolver>::factorize_dense_preserves_upper() const
+    {
+        // LLT and LDLT only touch the lower triangle, LU stores U in the upper one
+        return !std::is_same_v<DenseSolver, Eigen::PartialPivLU<Eigen::MatrixXd>>;
+    }
+
     // Solve the linear system
     template <typename DenseSolver>
     void EigenDenseSolver<DenseSolver>::solve(
         const Ref<const VectorXd> b, Ref<VectorXd> x)
     {
-        x = m_Solver.solve(b);
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
+        if (m_InplaceSolver)
+            x = m_InplaceSolver->solve(b);
+        else
+            x = m_Solver.solve(b);
     }
 } // namespace polysolve::linear
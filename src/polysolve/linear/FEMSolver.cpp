@@ -1,6 +1,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "FEMSolver.hpp"
 
+#include <polysolve/BinaryIO.hpp>
+
 #ifdef POLYSOLVE_WITH_SPECTRA
 #include <MatOp/SparseSymMatProd.h>
 #include <MatOp/SparseSymShiftSolve.h>
@@ -254,7 +256,7 @@ namespace polysolve::linear
 
         if (!save_path.empty())
         {
-            Eigen::saveMarket(A, save_path);
+            save_matrix(save_path, A);
         }
 
         if (should_compute_spectrum)
@@ -312,7 +314,7 @@ namespace polysolve::linear
 
         if (!save_path.empty())
         {
-            Eigen::saveMarket(A, save_path);
+            save_matrix(save_path, A);
         }
     }
 
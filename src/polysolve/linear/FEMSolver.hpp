@@ -31,6 +31,10 @@ namespace polysolve::linear
     ///                                 system. }
     /// @param[in]     dirichlet_nodes  { List of ids of Dirichlet nodes }
     /// @param[in,out] x                { Unknown vector }
+    /// @param[in]     save_path        { If not empty, the modified matrix is saved
+    ///                                 there, as Matrix Market for .mtx and .mat
+    ///                                 extensions and in the binary format of
+    ///                                 BinaryIO.hpp otherwise }
     ///
     Eigen::Vector4d dirichlet_solve(Solver &solver, StiffnessMatrix &A,
                                     Eigen::VectorXd &b, const std::vector<int> &dirichlet_nodes, Eigen::VectorXd &x,
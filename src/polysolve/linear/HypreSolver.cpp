@@ -2,9 +2,12 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "HypreSolver.hpp"
+#include <polysolve/Tracing.hpp>
 
 #include <HYPRE_krylov.h>
 #include <HYPRE_utilities.h>
+
+#include <algorithm>
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace polysolve::linear
@@ -64,6 +67,7 @@ namespace polysolve::linear
 
     void HypreSolver::factorize(const StiffnessMatrix &Ain)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
         assert(precond_num_ > 0);
 
         if (has_matrix_)
@@ -185,6 +189,7 @@ namespace polysolve::linear
 
     void HypreSolver::solve(const Eigen::Ref<const VectorXd> rhs, Eigen::Ref<VectorXd> result)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
         HYPRE_IJVector b;
         HYPRE_ParVector par_b;
         HYPRE_IJVector x;
@@ -264,11 +269,31 @@ namespace polysolve::linear
 
         /* Now setup and solve! */
         HYPRE_ParCSRPCGSetup(solver, parcsr_A, par_b, par_x);
-        HYPRE_ParCSRPCGSolve(solver, parcsr_A, par_b, par_x);
+        if (!m_cancellation)
+        {
+            HYPRE_ParCSRPCGSolve(solver, parcsr_A, par_b, par_x);
 
-        /* Run info - needed logging turned on */
-        HYPRE_PCGGetNumIterations(solver, &num_iterations);
-        HYPRE_PCGGetFinalRelativeResidualNorm(solver, &final_res_norm);
+            /* Run info - needed logging turned on */
+            HYPRE_PCGGetNumIterations(solver, &num_iterations);
+            HYPRE_PCGGetFinalRelativeResidualNorm(solver, &final_res_norm);
+        }
+        else
+        {
+            /* Solve in growing chunks restarted from the current iterate, to check the token in between */
+            HYPRE_Int total_iterations = 0;
+            HYPRE_Int chunk = CANCELLATION_CHECK_INTERVAL;
+            do
+            {
+                HYPRE_PCGSetMaxIter(solver, std::min<HYPRE_Int>(chunk, max_iter_ - total_iterations));
+                HYPRE_ParCSRPCGSolve(solver, parcsr_A, par_b, par_x);
+
+                HYPRE_PCGGetNumIterations(solver, &num_iterations);
+                HYPRE_PCGGetFinalRelativeResidualNorm(solver, &final_res_norm);
+                total_iterations += num_iterations;
+                chunk *= 2;
+            } while (final_res_norm > conv_tol_ && total_iterations < max_iter_ && !is_cancelled());
+            num_iterations = total_iterations;
+        }
 
         // printf("\n");
         // printf("Iterations = %lld\n", num_iterations);
@@ -41,12 +41,18 @@ namespace polysolve::linear
         // Retrieve memory information from Pardiso
         virtual void get_info(json &params) const override;
 
+        // Iterations of the last solve
+        virtual int iterations() const override { return num_iterations; }
+
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) override { precond_num_ = precond_num; }
 
         // Factorize system matrix
         virtual void factorize(const StiffnessMatrix &A) override;
 
+        // Set the relative tolerance of the next solves
+        virtual void set_tolerance(const double tol) override { conv_tol_ = tol; }
+
         // Solve the linear system Ax = b
         virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override;
 
@@ -0,0 +1,158 @@
+#ifdef POLYSOLVE_WITH_LAPACK
+
+////////////////////////////////////////////////////////////////////////////////
+#include "Lapack.hpp"
+#include <polysolve/Tracing.hpp>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+////////////////////////////////////////////////////////////////////////////////
+extern "C"
+{
+    // LAPACK prototypes (Fortran calling convention).
+    void dpotrf_(const char *, const int *, double *, const int *, int *);
+    void dpotrs_(const char *, const int *, const int *, const double *, const int *, double *, const int *, int *);
+    void dsytrf_(const char *, const int *, double *, const int *, int *, double *, const int *, int *);
+    void dsytrs_(const char *, const int *, const int *, const double *, const int *, const int *, double *, const int *, int *);
+    void dgetrf_(const int *, const int *, double *, const int *, int *, int *);
+    void dgetrs_(const char *, const int *, const int *, const double *, const int *, const int *, double *, const int *, int *);
+}
+////////////////////////////////////////////////////////////////////////////////
+
+namespace polysolve::linear
+{
+    LapackDense::LapackDense(const Type type)
+        : type_(type)
+    {
+    }
+
+    std::string LapackDense::name() const
+    {
+        switch (type_)
+        {
+        case Type::LLT:
+            return "LAPACK::LLT";
+        case Type::LDLT:
+            return "LAPACK::LDLT";
+        case Type::LU:
+            return "LAPACK::LU";
+        }
+        return "LAPACK";
+    }
+
+    void LapackDense::get_info(json &params) const
+    {
+        params["solver_info"] = info_ == 0 ? "Success" : "NumericalIssue";
+        params["lapack_info"] = info_;
+
+        const int64_t n = factors_ ? factors_->rows() : 0;
+        params["factor_nnz"] = n * n;
+        params["factor_bytes"] = n * n * int64_t(sizeof(double));
+        params["factor_inplace"] = factors_ != nullptr && factors_ != &own_factors_;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void LapackDense::factorize(const StiffnessMatrix &A)
+    {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
+        own_factors_ = Eigen::MatrixXd(A);
+        factorize_storage(own_factors_);
+    }
+
+    void LapackDense::factorize_dense(const Eigen::MatrixXd &A)
+    {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
+        own_factors_ = A;
+        factorize_storage(own_factors_);
+    }
+
+    void LapackDense::factorize_dense_inplace(Eigen::MatrixXd &A)
+    {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
+        // Release the previous factors before computing the new ones
+        own_factors_.resize(0, 0);
+        factorize_storage(A);
+    }
+
+    void LapackDense::factorize_storage(Eigen::MatrixXd &A)
+    {
+        assert(A.rows() == A.cols());
+        factors_ = &A;
+
+        const int n = int(A.rows());
+        const int lda = std::max(1, n);
+        const char uplo = 'L';
+
+        switch (type_)
+        {
+        case Type::LLT:
+            dpotrf_(&uplo, &n, A.data(), &lda, &info_);
+            break;
+        case Type::LDLT:
+        {
+            ipiv_.resize(n);
+            int lwork = -1;
+            double wkopt = 0;
+            dsytrf_(&uplo, &n, A.data(), &lda, ipiv_.data(), &wkopt, &lwork, &info_);
+            lwork = std::max(1, int(wkopt));
+            if (int(work_.size()) < lwork)
+                work_.resize(lwork);
+            lwork = int(work_.size());
+            dsytrf_(&uplo, &n, A.data(), &lda, ipiv_.data(), work_.data(), &lwork, &info_);
+            break;
+        }
+        case Type::LU:
+            ipiv_.resize(n);
+            dgetrf_(&n, &n, A.data(), &lda, ipiv_.data(), &info_);
+            break;
+        }
+
+        if (info_ < 0)
+            throw std::runtime_error("[LAPACK] Illegal argument " + std::to_string(-info_) + " in " + name());
+        if (info_ > 0)
+            throw std::runtime_error("[LAPACK] Singular or indefinite matrix in " + name() + " (info=" + std::to_string(info_) + ")");
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+
+    void LapackDense::solve(const Ref<const VectorXd> b, Ref<VectorXd> x)
+    {
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
+        if (factors_ == nullptr)
+            throw std::runtime_error("[LAPACK] solve called before factorize");
+
+        const Eigen::MatrixXd &A = *factors_;
+        assert(A.rows() == b.size());
+
+        const int n = int(A.rows());
+        const int lda = std::max(1, n);
+        const int nrhs = 1;
+        const char uplo = 'L';
+        const char trans = 'N';
+        int info = 0;
+
+        x = b;
+        const int ldb = std::max(1, int(x.size()));
+
+        switch (type_)
+        {
+        case Type::LLT:
+            dpotrs_(&uplo, &n, &nrhs, A.data(), &lda, x.data(), &ldb, &info);
+            break;
+        case Type::LDLT:
+            dsytrs_(&uplo, &n, &nrhs, A.data(), &lda, ipiv_.data(), x.data(), &ldb, &info);
+            break;
+        case Type::LU:
+            dgetrs_(&trans, &n, &nrhs, A.data(), &lda, ipiv_.data(), x.data(), &ldb, &info);
+            break;
+        }
+
+        if (info != 0)
+            throw std::runtime_error("[LAPACK] ERROR during solve: " + std::to_string(info));
+    }
+
+} // namespace polysolve::linear
+
+#endif
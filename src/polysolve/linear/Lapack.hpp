@@ -0,0 +1,73 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+#include "Solver.hpp"
+#include <Eigen/Core>
+#include <vector>
+////////////////////////////////////////////////////////////////////////////////
+//
+// Dense direct solvers calling the system LAPACK (reference, OpenBLAS, MKL or
+// Accelerate). Multithreading is inherited from the underlying BLAS.
+//
+
+namespace polysolve::linear
+{
+
+    class LapackDense : public Solver
+    {
+
+    public:
+        enum class Type
+        {
+            LLT,  // dpotrf, symmetric positive definite
+            LDLT, // dsytrf, symmetric indefinite (Bunch-Kaufman)
+            LU    // dgetrf, general
+        };
+
+        LapackDense(const Type type);
+
+    private:
+        POLYSOLVE_DELETE_MOVE_COPY(LapackDense)
+
+    public:
+        //////////////////////
+        // Public interface //
+        //////////////////////
+
+        // Get info on the last factorization
+        virtual void get_info(json &params) const override;
+
+        // Factorize system matrix
+        virtual void factorize(const StiffnessMatrix &A) override;
+
+        // Factorize system matrix of a dense matrix
+        virtual void factorize_dense(const Eigen::MatrixXd &A) override;
+
+        // Factorize system matrix reusing its storage
+        virtual void factorize_dense_inplace(Eigen::MatrixXd &A) override;
+
+        // LU overwrites the whole matrix
+        virtual bool factorize_dense_preserves_upper() const override { return type_ != Type::LU; }
+
+        // If solver uses dense matrices
+        virtual bool is_dense() const override { return true; }
+
+        // Solve the linear system Ax = b
+        virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override;
+
+        // Name of the solver type (for debugging purposes)
+        virtual std::string name() const override;
+
+    protected:
+        void factorize_storage(Eigen::MatrixXd &A);
+
+        Type type_;
+
+        Eigen::MatrixXd own_factors_;        // used when the factorization is not in place
+        Eigen::MatrixXd *factors_ = nullptr; // either &own_factors_ or the user matrix
+        std::vector<int> ipiv_;              // pivots for LDLT and LU
+        std::vector<double> work_;           // workspace for dsytrf
+        int info_ = 0;                       // info returned by the last factorization
+    };
+
+} // namespace polysolve::linear
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+#include "MemoryLimitedSolver.hpp"
+
+#include <spdlog/spdlog.h>
+////////////////////////////////////////////////////////////////////////////////
+
+namespace polysolve::linear
+{
+    MemoryLimitedSolver::MemoryLimitedSolver(std::unique_ptr<Solver> direct, const json &params, spdlog::logger &logger)
+        : direct_(std::move(direct)), params_(params), logger_(logger)
+    {
+        memory_limit_ = params["memory_limit"].get<double>() * 1024 * 1024;
+    }
+
+    void MemoryLimitedSolver::set_parameters(const json &params)
+    {
+        params_.merge_patch(params);
+        direct_->set_parameters(params);
+        if (fallback_)
+            fallback_->set_parameters(params);
+    }
+
+    void MemoryLimitedSolver::get_info(json &params) const
+    {
+        active().get_info(params);
+        params["memory_fallback"] = use_fallback_;
+    }
+
+    void MemoryLimitedSolver::analyze_pattern(const StiffnessMatrix &A, const int precond_num)
+    {
+        use_fallback_ = false;
+        direct_->analyze_pattern(A, precond_num);
+
+        const int64_t estimate = direct_->estimated_factor_bytes();
+        if (estimate < 0 || estimate <= memory_limit_)
+            return;
+
+        if (!fallback_)
+        {
+            fallback_ = Solver::create(params_["memory_limit_fallback"], params_["precond"]);
+            fallback_->set_parameters(params_);
+            if (block_size_ > 0)
+                fallback_->set_block_size(block_size_);
+            if (nullspace_.size() > 0)
+                fallback_->set_is_nullspace(nullspace_);
+            if (tolerance_ > 0)
+                fallback_->set_tolerance(tolerance_);
+            fallback_->set_cancellation_token(m_cancellation);
+        }
+
+        logger_.warn(
+            "Factors of {} estimated to {:.2f} MB, above the memory limit of {:.2f} MB; using {}",
+            direct_->name(), estimate / (1024. * 1024.), memory_limit_ / (1024. * 1024.), fallback_->name());
+
+        use_fallback_ = true;
+        fallback_->analyze_pattern(A, precond_num);
+    }
+
+    void MemoryLimitedSolver::set_block_size(int block_size)
+    {
+        block_size_ = block_size;
+        direct_->set_block_size(block_size);
+        if (fallback_)
+            fallback_->set_block_size(block_size);
+    }
+
+    void MemoryLimitedSolver::set_is_nullspace(const VectorXd &x)
+    {
+        nullspace_ = x;
+        direct_->set_is_nullspace(x);
+        if (fallback_)
+            fallback_->set_is_nullspace(x);
+    }
+
+    void MemoryLimitedSolver::set_tolerance(const double tol)
+    {
+        tolerance_ = tol;
+        direct_->set_tolerance(tol);
+        if (fallback_)
+            fallback_->set_tolerance(tol);
+    }
+
+    void MemoryLimitedSolver::set_cancellation_token(const std::shared_ptr<const CancellationToken> &token)
+    {
+        Solver::set_cancellation_token(token);
+        direct_->set_cancellation_token(token);
+        if (fallback_)
+            fallback_->set_cancellation_token(token);
+    }
+
+} // namespace polysolve::linear
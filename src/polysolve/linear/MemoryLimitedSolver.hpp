@@ -0,0 +1,88 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+#include "Solver.hpp"
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+////////////////////////////////////////////////////////////////////////////////
+//
+// Wraps a direct solver and switches to an iterative fallback when the factors
+// estimated by the symbolic analysis would exceed the memory budget.
+//
+
+namespace polysolve::linear
+{
+
+    class MemoryLimitedSolver : public Solver
+    {
+
+    public:
+        MemoryLimitedSolver(std::unique_ptr<Solver> direct, const json &params, spdlog::logger &logger);
+
+    private:
+        POLYSOLVE_DELETE_MOVE_COPY(MemoryLimitedSolver)
+
+    public:
+        //////////////////////
+        // Public interface //
+        //////////////////////
+
+        // Set solver parameters
+        virtual void set_parameters(const json &params) override;
+
+        // Get info of the active solver
+        virtual void get_info(json &params) const override;
+
+        // Iterations of the last solve of the active solver
+        virtual int iterations() const override { return active().iterations(); }
+
+        // Analyze sparsity pattern, selects the active solver
+        virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) override;
+
+        // Factorize system matrix
+        virtual void factorize(const StiffnessMatrix &A) override { active().factorize(A); }
+
+        // Dense systems always go to the direct solver
+        virtual void analyze_pattern_dense(const Eigen::MatrixXd &A, const int precond_num) override { direct_->analyze_pattern_dense(A, precond_num); }
+        virtual void factorize_dense(const Eigen::MatrixXd &A) override { direct_->factorize_dense(A); }
+        virtual bool is_dense() const override { return direct_->is_dense(); }
+
+        // Estimated size of the factors of the active solver
+        virtual int64_t estimated_factor_bytes() const override { return active().estimated_factor_bytes(); }
+
+        // Set block size for multigrid solvers
+        virtual void set_block_size(int block_size) override;
+
+        // If the problem is nullspace for multigrid solvers
+        virtual void set_is_nullspace(const VectorXd &x) override;
+
+        // Set the relative tolerance of both solvers
+        virtual void set_tolerance(const double tol) override;
+
+        // Set the cancellation token of both solvers
+        virtual void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) override;
+
+        // Solve the linear system Ax = b
+        virtual void solve(const Ref<const VectorXd> b, Ref<VectorXd> x) override { active().solve(b, x); }
+
+        // Name of the solver type (for debugging purposes)
+        virtual std::string name() const override { return active().name(); }
+
+    private:
+        Solver &active() const { return use_fallback_ ? *fallback_ : *direct_; }
+
+        std::unique_ptr<Solver> direct_;
+        std::unique_ptr<Solver> fallback_; // created on first use
+
+        json params_;
+        double memory_limit_; // in bytes
+        bool use_fallback_ = false;
+
+        int block_size_ = 0;
+        VectorXd nullspace_;
+        double tolerance_ = -1; // negative if never set
+
+        spdlog::logger &logger_;
+    };
+
+} // namespace polysolve::linear
@@ -2,6 +2,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 #include "Pardiso.hpp"
+#include <polysolve/Tracing.hpp>
 #include <thread>
 #ifdef POLYSOLVE_WITH_MKL
 #include <mkl_pardiso.h>
@@ -60,6 +61,14 @@ namespace polysolve::linear
         params["mem_numerical_fact"] = iparm[16];
         params["mem_total_peak"] = std::max(iparm[14], iparm[15] + iparm[16]);
         params["num_nonzero_factors"] = iparm[17];
+        params["factor_nnz"] = iparm[17];
+        params["factor_bytes"] = estimated_factor_bytes();
+    }
+
+    int64_t Pardiso::estimated_factor_bytes() const
+    {
+        // Pardiso reports memory in KB
+        return int64_t(std::max(iparm[14], iparm[15] + iparm[16])) * 1024;
     }
 
     ////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +211,7 @@ namespace polysolve::linear
 
     void Pardiso::analyze_pattern(const StiffnessMatrix &A, const int precond_num)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: analyze_pattern");
         if (mtype == -1)
         {
             throw std::runtime_error("[Pardiso] mtype not set.");
@@ -262,6 +272,7 @@ namespace polysolve::linear
 
     void Pardiso::factorize(const StiffnessMatrix &A)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: factorize");
         if (mtype == -1)
         {
             throw std::runtime_error("[Pardiso] mtype not set.");
@@ -296,6 +307,7 @@ namespace polysolve::linear
 
     void Pardiso::solve(const Eigen::Ref<const VectorXd> rhs, Eigen::Ref<VectorXd> result)
     {
+        POLYSOLVE_TRACE_SCOPE("linear solver: solve");
         if (mtype == -1)
         {
             throw std::runtime_error("[Pardiso] mtype not set.");
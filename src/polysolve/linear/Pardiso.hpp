@@ -43,6 +43,9 @@ namespace polysolve::linear
         // Retrieve memory information from Pardiso
         virtual void get_info(json &params) const override;
 
+        // Memory estimate of Pardiso after the symbolic factorization
+        virtual int64_t estimated_factor_bytes() const override;
+
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) override;
 
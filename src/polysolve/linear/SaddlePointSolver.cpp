@@ -169,6 +169,8 @@ namespace polysolve::linear
         auto symmetric_solver = Solver::create(symmetric_solver_name_, "");
         asymmetric_solver->set_parameters(asymmetric_solver_params_);
         symmetric_solver->set_parameters(symmetric_solver_params_);
+        asymmetric_solver->set_cancellation_token(m_cancellation);
+        symmetric_solver->set_cancellation_token(m_cancellation);
 
         symmetric_solver->analyze_pattern(Ss, Ss.rows());
         symmetric_solver->factorize(Ss);
@@ -263,7 +265,7 @@ namespace polysolve::linear
             compute_solution(i + 1, alphau, alphap, yu, yp, Wm, Wc, result);
             final_res_norm_ = (Ain_ * result - rhs).norm();
 
-            if (final_res_norm_ < conv_tol_)
+            if (final_res_norm_ < conv_tol_ || is_cancelled())
             {
                 break;
             }
@@ -33,6 +33,9 @@ namespace polysolve::linear
         // Retrieve memory information from Pardiso
         virtual void get_info(json &params) const override;
 
+        // Iterations of the last solve
+        virtual int iterations() const override { return num_iterations_; }
+
         // Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) override { precond_num_ = precond_num; }
 
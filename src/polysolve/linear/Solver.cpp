@@ -4,6 +4,7 @@
 #include "Solver.hpp"
 #include "EigenSolver.hpp"
 #include "SaddlePointSolver.hpp"
+#include "MemoryLimitedSolver.hpp"
 
 #include <jse/jse.h>
 #include <spdlog/spdlog.h>
@@ -54,6 +55,9 @@ namespace polysolve::linear {
 #ifdef POLYSOLVE_WITH_PARDISO
 #include "Pardiso.hpp"
 #endif
+#ifdef POLYSOLVE_WITH_LAPACK
+#include "Lapack.hpp"
+#endif
 #ifdef POLYSOLVE_WITH_HYPRE
 #include "HypreSolver.hpp"
 #endif
@@ -131,6 +135,30 @@ namespace polysolve::linear
                 params[lin_solver_ptr] = Solver::default_solver();
             }
         }
+
+        // Iterative solver used when the factors of a direct solver exceed memory_limit
+        const auto memory_limit_ptr = "/memory_limit"_json_pointer;
+        const auto memory_fallback_ptr = "/memory_limit_fallback"_json_pointer;
+        if (params.contains(memory_limit_ptr) && params[memory_limit_ptr].get<double>() > 0)
+        {
+            const std::vector<std::string> ss = Solver::available_solvers();
+            const std::string fallback = params.contains(memory_fallback_ptr) ? params[memory_fallback_ptr].get<std::string>() : "";
+            if (std::find(ss.begin(), ss.end(), fallback) == ss.end())
+            {
+                std::string accepted_fallback = "Eigen::ConjugateGradient";
+                for (const char *s : {"AMGCL", "Hypre"})
+                {
+                    if (std::find(ss.begin(), ss.end(), s) != ss.end())
+                    {
+                        accepted_fallback = s;
+                        break;
+                    }
+                }
+                if (!fallback.empty())
+                    logger.warn("Memory limit fallback solver {} is invalid, using {}", fallback, accepted_fallback);
+                params[memory_fallback_ptr] = accepted_fallback;
+            }
+        }
     }
 
     std::unique_ptr<Solver> Solver::create(const json &params_in, spdlog::logger &logger, const bool strict_validation)
@@ -162,6 +190,9 @@ namespace polysolve::linear
         auto res = create(params["solver"], params["precond"]);
         res->set_parameters(params);
 
+        if (params["memory_limit"].get<double>() > 0 && !res->is_dense())
+            res = std::make_unique<MemoryLimitedSolver>(std::move(res), params, logger);
+
         return res;
     }
 
@@ -314,6 +345,10 @@ namespace polysolve::linear
         {
             RETURN_DIRECT_SOLVER_PTR(SimplicialLDLT, "Eigen::SimplicialLDLT");
         }
+        else if (solver == "Eigen::SimplicialLLT")
+        {
+            RETURN_DIRECT_SOLVER_PTR(SimplicialLLT, "Eigen::SimplicialLLT");
+        }
         else if (solver == "Eigen::SparseLU")
         {
             RETURN_DIRECT_SOLVER_PTR(SparseLU, "Eigen::SparseLU");
@@ -480,6 +515,20 @@ namespace polysolve::linear
         {
             RETURN_DIRECT_DENSE_SOLVER_PTR(LDLT, "Eigen::LDLT");
         }
+#ifdef POLYSOLVE_WITH_LAPACK
+        else if (solver == "LAPACK::LLT")
+        {
+            return std::make_unique<LapackDense>(LapackDense::Type::LLT);
+        }
+        else if (solver == "LAPACK::LDLT")
+        {
+            return std::make_unique<LapackDense>(LapackDense::Type::LDLT);
+        }
+        else if (solver == "LAPACK::LU")
+        {
+            return std::make_unique<LapackDense>(LapackDense::Type::LU);
+        }
+#endif
         // else if (solver == "Eigen::BDCSVD")
         // {
         //     RETURN_DIRECT_DENSE_SOLVER_PTR(BDCSVD, "Eigen::BDCSVD");
@@ -498,6 +547,7 @@ namespace polysolve::linear
     {
         return {{
             "Eigen::SimplicialLDLT",
+            "Eigen::SimplicialLLT",
             "Eigen::SparseLU",
             "Eigen::SparseQR",
 #ifdef POLYSOLVE_WITH_ACCELERATE
@@ -554,7 +604,12 @@ namespace polysolve::linear
             "Eigen::FullPivHouseholderQR",
             "Eigen::CompleteOrthogonalDecomposition",
             "Eigen::LLT",
-            "Eigen::LDLT"
+            "Eigen::LDLT",
+#ifdef POLYSOLVE_WITH_LAPACK
+            "LAPACK::LLT",
+            "LAPACK::LDLT",
+            "LAPACK::LU",
+#endif
             // "Eigen::BDCSVD",
             // "Eigen::JacobiSVD"
         }};
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <polysolve/Types.hpp>
+#include <polysolve/Cancellation.hpp>
 
+#include <cstdint>
 #include <memory>
 
 #define POLYSOLVE_DELETE_MOVE_COPY(Base) \
@@ -92,6 +94,9 @@ namespace polysolve::linear
         /// Get info on the last solve step
         virtual void get_info(json &params) const {};
 
+        /// Iterations of the last solve of the iterative solvers (negative for direct solvers)
+        virtual int iterations() const { return -1; }
+
         /// Analyze sparsity pattern
         virtual void analyze_pattern(const StiffnessMatrix &A, const int precond_num) {}
 
@@ -104,15 +109,36 @@ namespace polysolve::linear
         /// Factorize system matrix of a dense matrix
         virtual void factorize_dense(const Eigen::MatrixXd &A) {}
 
+        /// Factorize a dense system matrix reusing its storage for the factors.
+        /// A must stay alive and untouched until the last call to solve.
+        /// If factorize_dense_preserves_upper() is true, only the lower triangle
+        /// and the diagonal of A are overwritten, otherwise A is fully clobbered.
+        /// The default implementation copies A and leaves it untouched.
+        virtual void factorize_dense_inplace(Eigen::MatrixXd &A) { factorize_dense(A); }
+
+        /// If factorize_dense_inplace leaves the strict upper triangle of A untouched
+        virtual bool factorize_dense_preserves_upper() const { return true; }
+
         /// If solver uses dense matrices
         virtual bool is_dense() const { return false; }
 
+        /// Estimated size in bytes of the factors, available after analyze_pattern (negative if unknown)
+        virtual int64_t estimated_factor_bytes() const { return -1; }
+
         /// Set block size for multigrid solvers
         virtual void set_block_size(int block_size) {}
 
         /// If the problem is nullspace for multigrid solvers
         virtual void set_is_nullspace(const VectorXd &x) {}
 
+        /// Set the relative tolerance ‖Ax - b‖ ≤ tol ‖b‖ of the next solves
+        /// (iterative solvers only, direct solvers ignore it)
+        virtual void set_tolerance(const double tol) {}
+
+        /// Token checked between the iterations of the iterative solvers, which stop
+        /// early with their current iterate once it is cancelled (direct solvers ignore it)
+        virtual void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) { m_cancellation = token; }
+
         ///
         /// @brief         { Solve the linear system Ax = b }
         ///
@@ -126,6 +152,15 @@ namespace polysolve::linear
 
         /// @brief Name of the solver type (for debugging purposes)
         virtual std::string name() const { return ""; }
+
+    protected:
+        /// Iterations before the first check of the cancellation token by the iterative solvers,
+        /// they restart from their iterate at each check so the interval then doubles
+        static constexpr int CANCELLATION_CHECK_INTERVAL = 64;
+
+        bool is_cancelled() const { return m_cancellation && m_cancellation->is_cancelled(); }
+
+        std::shared_ptr<const CancellationToken> m_cancellation;
     };
 
 } // namespace polysolve::linear
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <polysolve/Types.hpp>
+
+namespace polysolve::nonlinear
+{
+    /// @brief Many independent small problems with the same number of dofs, minimized together
+    /// by the BatchedSolver. The iterates are in structure-of-arrays layout: row p of X holds the
+    /// dofs of problem p, so a column (one dof of every problem) is contiguous and the
+    /// evaluations can be vectorized across problems.
+    /// All the problems are evaluated at every call, the ones that already stopped at a fixed point.
+    class BatchedProblem
+    {
+    public:
+        using TMatrix = Eigen::MatrixXd;
+        using TVector = Eigen::VectorXd;
+
+        virtual ~BatchedProblem() = default;
+
+        /// @brief Number of problems N (rows of X).
+        virtual int num_problems() const = 0;
+
+        /// @brief Number of dofs n of each problem (columns of X).
+        virtual int num_dofs() const = 0;
+
+        /// @brief Compute the value of every problem.
+        /// @param[in] X N × n dofs.
+        /// @param[out] f f(p) is the value of problem p at X.row(p).
+        virtual void value(const TMatrix &X, TVector &f) = 0;
+
+        /// @brief Compute the value and gradient of every problem.
+        /// @param[in] X N × n dofs.
+        /// @param[out] f Values.
+        /// @param[out] grad N × n gradients, row p is the gradient of problem p.
+        virtual void value_and_gradient(const TMatrix &X, TVector &f, TMatrix &grad) = 0;
+
+        /// @brief Compute the Hessian of every problem, only used by Newton.
+        /// @param[in] X N × n dofs.
+        /// @param[out] hessian N × n² entries, column i + j n holds ∂²f/∂xᵢ∂xⱼ of every problem.
+        virtual void hessian(const TMatrix &X, TMatrix &hessian)
+        {
+            throw std::runtime_error("Batched Hessian not implemented.");
+        }
+    };
+} // namespace polysolve::nonlinear
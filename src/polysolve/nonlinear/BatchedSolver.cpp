@@ -0,0 +1,376 @@
+#include "BatchedSolver.hpp"
+
+#include "Solver.hpp"
+
+#include <polysolve/Utils.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace polysolve::nonlinear
+{
+    namespace
+    {
+        using Mask = Eigen::Array<bool, Eigen::Dynamic, 1>;
+
+        /// Dot products of the rows of A and B, accumulated column by column so that
+        /// the inner loop runs over contiguous lanes
+        Eigen::VectorXd row_dot(const Eigen::MatrixXd &A, const Eigen::MatrixXd &B)
+        {
+            Eigen::VectorXd res = Eigen::VectorXd::Zero(A.rows());
+            for (int j = 0; j < A.cols(); ++j)
+                res.array() += A.col(j).array() * B.col(j).array();
+            return res;
+        }
+    } // namespace
+
+    std::unique_ptr<BatchedSolver> BatchedSolver::create(
+        const json &solver_params_in,
+        const double characteristic_length,
+        spdlog::logger &logger,
+        const bool strict_validation)
+    {
+        json solver_params = Solver::validate_params(solver_params_in, logger, strict_validation);
+
+        if (!solver_params["solver"].is_string())
+            log_and_throw_error(logger, "BatchedSolver takes a single solver, not a list");
+
+        return std::make_unique<BatchedSolver>(solver_params, characteristic_length, logger);
+    }
+
+    std::vector<std::string> BatchedSolver::available_solvers()
+    {
+        return {"Newton", "L-BFGS"};
+    }
+
+    BatchedSolver::BatchedSolver(const json &solver_params,
+                                 const double characteristic_length,
+                                 spdlog::logger &logger)
+        : m_logger(logger)
+    {
+        const std::string solver_name = solver_params["solver"];
+        if (solver_name == "Newton" || solver_name == "DenseNewton" || solver_name == "newton" || solver_name == "dense_newton")
+            m_use_newton = true;
+        else if (solver_name == "L-BFGS" || solver_name == "LBFGS" || solver_name == "lbfgs")
+            m_use_newton = false;
+        else
+            log_and_throw_error(logger, "BatchedSolver only supports Newton and L-BFGS, instead got {}", solver_name);
+
+        m_history_size = solver_params["L-BFGS"]["history_size"];
+        if (m_history_size <= 0)
+            log_and_throw_error(logger, "L-BFGS history_size must be > 0, instead got {}", m_history_size);
+
+        m_armijo_c = solver_params["line_search"]["Armijo"]["c"];
+        m_step_ratio = solver_params["line_search"]["step_ratio"];
+        m_max_step_size_iter = solver_params["line_search"]["max_step_size_iter"];
+
+        // Same criteria as Solver
+        m_stop.xDelta = solver_params["x_delta"];
+        m_stop.fDelta = solver_params["advanced"]["f_delta"];
+        m_stop.gradNorm = solver_params["grad_norm"];
+        m_stop.firstGradNorm = solver_params["first_grad_norm_tol"];
+        m_stop.xDeltaDotGrad = -solver_params["advanced"]["derivative_along_delta_x_tol"].get<double>();
+
+        m_stop.xDelta *= characteristic_length;
+        m_stop.fDelta *= characteristic_length;
+        m_stop.gradNorm *= characteristic_length;
+        m_stop.firstGradNorm *= characteristic_length;
+
+        m_stop.iterations = solver_params["max_iterations"];
+        m_stop.fDeltaCount = solver_params["advanced"]["f_delta_step_tol"];
+    }
+
+    void BatchedSolver::minimize(BatchedProblem &problem, TMatrix &X)
+    {
+        constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+        const int n_problems = problem.num_problems();
+        const int n_dofs = problem.num_dofs();
+        if (X.rows() != n_problems || X.cols() != n_dofs)
+            log_and_throw_error(m_logger, "[{}] X is {}×{}, expected {}×{}", name(), X.rows(), X.cols(), n_problems, n_dofs);
+
+        m_current.assign(n_problems, Criteria());
+        m_status.assign(n_problems, Status::Continue);
+
+        if (!m_use_newton)
+        {
+            m_history_count = 0;
+            m_s.assign(m_history_size, TMatrix::Zero(n_problems, n_dofs));
+            m_y.assign(m_history_size, TMatrix::Zero(n_problems, n_dofs));
+            m_rho.assign(m_history_size, TVector::Zero(n_problems));
+            m_gamma.setOnes(n_problems);
+        }
+
+        Mask active = Mask::Constant(n_problems, true);
+        // Lanes using -∇f, because their direction failed at the previous iteration
+        Mask fallback = Mask::Constant(n_problems, false);
+
+        TVector f(n_problems), old_f = TVector::Constant(n_problems, NaN), trial_f(n_problems);
+        TVector alpha(n_problems), grad_dot(n_problems);
+        TMatrix grad, old_grad, direction(n_problems, n_dofs), step, trial_X;
+
+        double total_time = 0;
+        StopWatch stop_watch(name(), total_time, m_logger);
+        stop_watch.start();
+
+        for (int it = 0; active.any(); ++it)
+        {
+            // --- Energy and gradient -----------------------------------------
+
+            problem.value_and_gradient(X, f, grad);
+
+            if (!m_use_newton && it > 0)
+                lbfgs_update(step, grad - old_grad);
+
+            const TVector grad_norm = row_dot(grad, grad).cwiseSqrt();
+
+            for (int p = 0; p < n_problems; ++p)
+            {
+                if (!active[p])
+                    continue;
+
+                Criteria &current = m_current[p];
+                if (!std::isfinite(f[p]) || std::isnan(grad_norm[p]))
+                {
+                    m_status[p] = Status::NanEncountered;
+                    active[p] = false;
+                    continue;
+                }
+
+                current.fDelta = std::abs(old_f[p] - f[p]);
+                current.gradNorm = grad_norm[p];
+                // Check convergence without these values, as in Solver
+                current.xDelta = NaN;
+                current.xDeltaDotGrad = NaN;
+                m_status[p] = checkConvergence(m_stop, current);
+                if (m_status[p] != Status::Continue)
+                    active[p] = false;
+            }
+
+            if (!active.any())
+                break;
+
+            // --- Update direction --------------------------------------------
+
+            if (m_use_newton)
+                newton_directions(problem, X, grad, direction);
+            else
+                lbfgs_directions(grad, direction);
+
+            grad_dot = row_dot(direction, grad);
+
+            for (int p = 0; p < n_problems; ++p)
+            {
+                if (!active[p])
+                {
+                    direction.row(p).setZero();
+                    alpha[p] = 0;
+                    continue;
+                }
+
+                // Revert to gradient descent on the lanes where the direction failed
+                if (fallback[p] || !std::isfinite(grad_dot[p]) || (grad_norm[p] != 0 && grad_dot[p] >= 0))
+                {
+                    direction.row(p) = -grad.row(p);
+                    grad_dot[p] = -grad_norm[p] * grad_norm[p];
+                    fallback[p] = true;
+                    if (!m_use_newton)
+                        lbfgs_reset(p);
+                }
+
+                Criteria &current = m_current[p];
+                current.xDelta = direction.row(p).norm();
+                current.xDeltaDotGrad = grad_dot[p];
+                m_status[p] = checkConvergence(m_stop, current);
+                if (m_status[p] != Status::Continue)
+                {
+                    active[p] = false;
+                    direction.row(p).setZero();
+                    alpha[p] = 0;
+                    continue;
+                }
+
+                alpha[p] = 1;
+            }
+
+            // --- Backtracking line search ------------------------------------
+
+            Mask searching = active;
+            for (int ls = 0; ls < m_max_step_size_iter && searching.any(); ++ls)
+            {
+                trial_X = X + alpha.asDiagonal() * direction;
+                problem.value(trial_X, trial_f);
+
+                for (int p = 0; p < n_problems; ++p)
+                {
+                    if (!searching[p])
+                        continue;
+                    if (std::isfinite(trial_f[p]) && trial_f[p] <= f[p] + m_armijo_c * alpha[p] * grad_dot[p])
+                        searching[p] = false;
+                    else
+                        alpha[p] *= m_step_ratio;
+                }
+            }
+
+            for (int p = 0; p < n_problems; ++p)
+            {
+                if (!active[p])
+                    continue;
+
+                if (searching[p])
+                {
+                    alpha[p] = 0;
+                    if (fallback[p])
+                    {
+                        // Line search failed on gradient descent, so quit this lane
+                        m_status[p] = Status::LineSearchFailed;
+                        active[p] = false;
+                        continue;
+                    }
+                    fallback[p] = true;
+                }
+                else
+                {
+                    fallback[p] = false;
+                }
+            }
+
+            // --- Variable update ---------------------------------------------
+
+            step = alpha.asDiagonal() * direction;
+            X += step;
+
+            old_f = f;
+            old_grad = grad;
+
+            for (int p = 0; p < n_problems; ++p)
+            {
+                if (!active[p])
+                    continue;
+
+                Criteria &current = m_current[p];
+                current.fDeltaCount = (current.fDelta < m_stop.fDelta) ? (current.fDeltaCount + 1) : 0;
+                if (++current.iterations >= m_stop.iterations)
+                {
+                    m_status[p] = Status::IterationLimit;
+                    active[p] = false;
+                }
+            }
+        }
+
+        stop_watch.stop();
+
+        const int converged = std::count_if(m_status.begin(), m_status.end(), is_converged_status);
+        m_logger.log(
+            converged == n_problems ? spdlog::level::debug : spdlog::level::warn,
+            "[{}] Finished: {}/{} problems converged, took {:g}s",
+            name(), converged, n_problems, stop_watch.getElapsedTimeInSec());
+    }
+
+    void BatchedSolver::newton_directions(
+        BatchedProblem &problem, const TMatrix &X, const TMatrix &grad, TMatrix &direction)
+    {
+        const int n_problems = X.rows();
+        const int n = X.cols();
+
+        TMatrix hessian;
+        problem.hessian(X, hessian);
+        if (hessian.rows() != n_problems || hessian.cols() != n * n)
+            log_and_throw_error(m_logger, "[{}] Hessian is {}×{}, expected {}×{}", name(), hessian.rows(), hessian.cols(), n_problems, n * n);
+
+        // Cholesky factorization H = LLᵀ of every lane, entry (i, j) of L in column i + j n.
+        // The lanes with a non-positive pivot keep going with a unit pivot and get -∇f.
+        TMatrix L(n_problems, n * n);
+        Mask not_pd = Mask::Constant(n_problems, false);
+        Eigen::ArrayXd v(n_problems);
+        for (int j = 0; j < n; ++j)
+        {
+            v = hessian.col(j + j * n).array();
+            for (int k = 0; k < j; ++k)
+                v -= L.col(j + k * n).array().square();
+            not_pd = not_pd || !(v > 0);
+            L.col(j + j * n) = (v > 0).select(v.sqrt(), 1.0);
+
+            for (int i = j + 1; i < n; ++i)
+            {
+                v = hessian.col(i + j * n).array();
+                for (int k = 0; k < j; ++k)
+                    v -= L.col(i + k * n).array() * L.col(j + k * n).array();
+                L.col(i + j * n) = v / L.col(j + j * n).array();
+            }
+        }
+
+        // Solve L z = -∇f, then Lᵀ d = z in place
+        direction.resize(n_problems, n);
+        for (int i = 0; i < n; ++i)
+        {
+            v = -grad.col(i).array();
+            for (int k = 0; k < i; ++k)
+                v -= L.col(i + k * n).array() * direction.col(k).array();
+            direction.col(i) = v / L.col(i + i * n).array();
+        }
+        for (int i = n - 1; i >= 0; --i)
+        {
+            v = direction.col(i).array();
+            for (int k = i + 1; k < n; ++k)
+                v -= L.col(k + i * n).array() * direction.col(k).array();
+            direction.col(i) = v / L.col(i + i * n).array();
+        }
+
+        for (int p = 0; p < n_problems; ++p)
+            if (not_pd[p])
+                direction.row(p) = -grad.row(p);
+    }
+
+    void BatchedSolver::lbfgs_directions(const TMatrix &grad, TMatrix &direction)
+    {
+        std::vector<TVector> a(m_history_count);
+
+        direction = grad;
+        for (int k = 0; k < m_history_count; ++k)
+        {
+            a[k] = m_rho[k].cwiseProduct(row_dot(m_s[k], direction));
+            direction -= a[k].asDiagonal() * m_y[k];
+        }
+
+        direction = m_gamma.asDiagonal() * direction;
+
+        for (int k = m_history_count - 1; k >= 0; --k)
+        {
+            const TVector b = m_rho[k].cwiseProduct(row_dot(m_y[k], direction));
+            direction += (a[k] - b).asDiagonal() * m_s[k];
+        }
+
+        direction *= -1;
+    }
+
+    void BatchedSolver::lbfgs_update(const TMatrix &s, const TMatrix &y)
+    {
+        constexpr double eps = std::numeric_limits<double>::epsilon();
+
+        const TVector sy = row_dot(s, y);
+        const TVector yy = row_dot(y, y);
+        const Mask valid = sy.array() > eps * yy.array();
+
+        // The oldest slot becomes the newest
+        std::rotate(m_s.rbegin(), m_s.rbegin() + 1, m_s.rend());
+        std::rotate(m_y.rbegin(), m_y.rbegin() + 1, m_y.rend());
+        std::rotate(m_rho.rbegin(), m_rho.rbegin() + 1, m_rho.rend());
+
+        m_s[0] = s;
+        m_y[0] = y;
+        // A zero ρ removes the pair from both loops of the recursion
+        m_rho[0] = valid.select(sy.cwiseInverse(), 0.0);
+        m_gamma = valid.select(sy.cwiseQuotient(yy), m_gamma);
+
+        m_history_count = std::min(m_history_count + 1, m_history_size);
+    }
+
+    void BatchedSolver::lbfgs_reset(const int lane)
+    {
+        for (TVector &rho : m_rho)
+            rho[lane] = 0;
+        m_gamma[lane] = 1;
+    }
+} // namespace polysolve::nonlinear
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BatchedProblem.hpp"
+#include "Criteria.hpp"
+
+namespace spdlog
+{
+    class logger;
+}
+
+namespace polysolve::nonlinear
+{
+    /// @brief Newton or L-BFGS minimization of a BatchedProblem. Each problem is a lane:
+    /// the directions, line searches, and convergence checks are computed column by column
+    /// over all the lanes, and a lane stops as soon as its own Criteria are met.
+    /// The parameters are the ones of Solver (tolerances, max_iterations, line_search/...).
+    class BatchedSolver
+    {
+    public:
+        using TMatrix = typename BatchedProblem::TMatrix;
+        using TVector = typename BatchedProblem::TVector;
+
+        /// @brief Static constructor, the parameters are validated with the nonlinear solver spec
+        static std::unique_ptr<BatchedSolver> create(
+            const json &solver_params,
+            const double characteristic_length,
+            spdlog::logger &logger,
+            const bool strict_validation = true);
+
+        /// @brief List available solvers
+        static std::vector<std::string> available_solvers();
+
+        BatchedSolver(const json &solver_params,
+                      const double characteristic_length,
+                      spdlog::logger &logger);
+
+        /// @brief Minimize every problem of the batch
+        /// @param problem Batch of problems
+        /// @param X N × n initial guesses, row p is the initial guess of problem p
+        void minimize(BatchedProblem &problem, TMatrix &X);
+
+        Criteria &stop_criteria() { return m_stop; }
+        const Criteria &stop_criteria() const { return m_stop; }
+        /// @brief Criteria of each problem
+        const std::vector<Criteria> &current_criteria() const { return m_current; }
+        /// @brief Status of each problem
+        const std::vector<Status> &status() const { return m_status; }
+
+        std::string name() const { return m_use_newton ? "BatchedNewton" : "BatchedL-BFGS"; }
+
+    private:
+        /// @brief Newton directions, lanes with a Hessian that is not positive definite get -∇f
+        void newton_directions(BatchedProblem &problem, const TMatrix &X, const TMatrix &grad, TMatrix &direction);
+
+        /// @brief L-BFGS two-loop recursion on every lane
+        void lbfgs_directions(const TMatrix &grad, TMatrix &direction);
+
+        /// @brief Add the pairs (s, y) to the history, skipping the lanes with sᵀy ≤ 0
+        void lbfgs_update(const TMatrix &s, const TMatrix &y);
+
+        /// @brief Forget the history of a lane
+        void lbfgs_reset(const int lane);
+
+        bool m_use_newton;
+
+        // Line search
+        double m_armijo_c;
+        double m_step_ratio;
+        int m_max_step_size_iter;
+
+        // L-BFGS history, slot k holds the k-th most recent pair
+        int m_history_size;
+        int m_history_count;
+        std::vector<TMatrix> m_s;
+        std::vector<TMatrix> m_y;
+        std::vector<TVector> m_rho; ///< 1 / sᵀy, 0 for the skipped pairs
+        TVector m_gamma;            ///< Initial inverse Hessian scaling sᵀy / yᵀy
+
+        Criteria m_stop;
+        std::vector<Criteria> m_current;
+        std::vector<Status> m_status;
+
+        spdlog::logger &m_logger;
+    };
+} // namespace polysolve::nonlinear
@@ -3,11 +3,8 @@
 #include "descent_strategies/box_constraints/LBFGSB.hpp"
 #include "descent_strategies/box_constraints/MMA.hpp"
 
-#include <jse/jse.h>
 #include <polysolve/JSONUtils.hpp>
 
-#include <fstream>
-
 namespace polysolve::nonlinear
 {
 
@@ -19,26 +16,7 @@ namespace polysolve::nonlinear
         spdlog::logger &logger,
         const bool strict_validation)
     {
-        json solver_params = solver_params_in; // mutable copy
-
-        json rules;
-        jse::JSE jse;
-
-        jse.strict = strict_validation;
-        const std::string input_spec = POLYSOLVE_NON_LINEAR_SPEC;
-        std::ifstream file(input_spec);
-
-        if (file.is_open())
-            file >> rules;
-        else
-            log_and_throw_error(logger, "unable to open {} rules", input_spec);
-
-        const bool valid_input = jse.verify_json(solver_params, rules);
-
-        if (!valid_input)
-            log_and_throw_error(logger, "invalid input json:\n{}", jse.log2str());
-
-        solver_params = jse.inject_defaults(solver_params, rules);
+        json solver_params = Solver::validate_params(solver_params_in, logger, strict_validation);
 
         const std::string solver_name = solver_params["solver"];
 
@@ -0,0 +1,196 @@
+#include "CachedProblem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string_view>
+
+namespace polysolve::nonlinear
+{
+    CachedProblem::CachedProblem(Problem &problem, const int capacity)
+        : problem(problem), capacity(std::max(capacity, 0))
+    {
+        entries.reserve(this->capacity);
+    }
+
+    void CachedProblem::init(const TVector &x0)
+    {
+        clear();
+        problem.init(x0);
+    }
+
+    CachedProblem::Scalar CachedProblem::value(const TVector &x)
+    {
+        if (capacity == 0)
+        {
+            ++m_evaluations;
+            return problem.value(x);
+        }
+
+        const size_t hash = hash_of(x);
+        if (Entry *entry = find(x, hash); entry && entry->has_value)
+        {
+            ++m_hits;
+            return entry->value;
+        }
+
+        ++m_evaluations;
+        const Scalar value = problem.value(x);
+        Entry &entry = insert(x, hash);
+        entry.value = value;
+        entry.has_value = true;
+        return value;
+    }
+
+    void CachedProblem::gradient(const TVector &x, TVector &grad)
+    {
+        if (capacity == 0)
+        {
+            ++m_evaluations;
+            problem.gradient(x, grad);
+            return;
+        }
+
+        const size_t hash = hash_of(x);
+        if (Entry *entry = find(x, hash); entry && entry->has_gradient)
+        {
+            ++m_hits;
+            grad = entry->gradient;
+            return;
+        }
+
+        ++m_evaluations;
+        problem.gradient(x, grad);
+        Entry &entry = insert(x, hash);
+        entry.gradient = grad;
+        entry.has_gradient = true;
+    }
+
+    void CachedProblem::value_and_gradient(const TVector &x, Scalar &f, TVector &grad)
+    {
+        if (capacity == 0)
+        {
+            ++m_evaluations;
+            problem.value_and_gradient(x, f, grad);
+            return;
+        }
+
+        const size_t hash = hash_of(x);
+        const Entry *cached = find(x, hash);
+        const bool has_value = cached && cached->has_value;
+        const bool has_gradient = cached && cached->has_gradient;
+
+        if (has_value)
+        {
+            ++m_hits;
+            f = cached->value;
+        }
+        if (has_gradient)
+        {
+            ++m_hits;
+            grad = cached->gradient;
+        }
+
+        if (!has_value || !has_gradient)
+            ++m_evaluations;
+
+        if (!has_value && !has_gradient)
+            problem.value_and_gradient(x, f, grad);
+        else if (!has_value)
+            f = problem.value(x);
+        else if (!has_gradient)
+            problem.gradient(x, grad);
+
+        Entry &entry = insert(x, hash);
+        entry.value = f;
+        entry.has_value = true;
+        entry.gradient = grad;
+        entry.has_gradient = true;
+    }
+
+    void CachedProblem::line_search_begin(const TVector &x0, const TVector &x1)
+    {
+        if (problem.callbacks_change_energy())
+            clear();
+        problem.line_search_begin(x0, x1);
+    }
+
+    void CachedProblem::post_step(const PostStepData &data)
+    {
+        if (problem.callbacks_change_energy())
+            clear();
+        problem.post_step(data);
+    }
+
+    bool CachedProblem::after_line_search_custom_operation(const TVector &x0, const TVector &x1)
+    {
+        const bool changed = problem.after_line_search_custom_operation(x0, x1);
+        if (changed)
+            clear();
+        return changed;
+    }
+
+    void CachedProblem::value_batch(
+        const TVector &x,
+        const TVector &direction,
+        const Eigen::VectorXd &alphas,
+        Eigen::VectorXd &fs,
+        Eigen::VectorXi &valid)
+    {
+        m_evaluations += alphas.size();
+        problem.value_batch(x, direction, alphas, fs, valid);
+        if (capacity == 0)
+            return;
+
+        // Failed evaluations are NaN and are not remembered
+        for (int i = 0; i < alphas.size(); ++i)
+        {
+            if (!std::isfinite(fs[i]))
+                continue;
+            const TVector new_x = x + alphas[i] * direction;
+            Entry &entry = insert(new_x, hash_of(new_x));
+            entry.value = fs[i];
+            entry.has_value = true;
+        }
+    }
+
+    void CachedProblem::clear()
+    {
+        entries.clear();
+    }
+
+    CachedProblem::Entry *CachedProblem::find(const TVector &x, const size_t hash)
+    {
+        const auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry &e) {
+            return e.hash == hash && e.x.size() == x.size() && e.x == x;
+        });
+        if (it == entries.end())
+            return nullptr;
+
+        std::rotate(entries.begin(), it, it + 1);
+        return &entries.front();
+    }
+
+    CachedProblem::Entry &CachedProblem::insert(const TVector &x, const size_t hash)
+    {
+        if (Entry *entry = find(x, hash))
+            return *entry;
+
+        if (entries.size() < size_t(capacity))
+            entries.emplace_back();
+        std::rotate(entries.begin(), entries.end() - 1, entries.end());
+
+        Entry &entry = entries.front();
+        entry.hash = hash;
+        entry.x = x;
+        entry.has_value = false;
+        entry.has_gradient = false;
+        return entry;
+    }
+
+    size_t CachedProblem::hash_of(const TVector &x)
+    {
+        return std::hash<std::string_view>()(std::string_view(
+            reinterpret_cast<const char *>(x.data()), x.size() * sizeof(Scalar)));
+    }
+} // namespace polysolve::nonlinear
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Problem.hpp"
+
+#include <vector>
+
+namespace polysolve::nonlinear
+{
+    /// @brief Problem forwarding to another one while remembering the values and gradients
+    /// of the last few distinct points, so that a point visited by both the line search and
+    /// the solver (e.g., the accepted step) is only evaluated once.
+    /// It assumes the value and gradient only depend on x once solution_changed(x) was called.
+    /// The cache is cleared when after_line_search_custom_operation reports a change, and in
+    /// line_search_begin and post_step only if the problem says they change its energy
+    /// (see Problem::callbacks_change_energy).
+    class CachedProblem : public Problem
+    {
+    public:
+        /// @param problem Problem to forward to.
+        /// @param capacity Number of points to remember, 0 only forwards and counts the evaluations.
+        CachedProblem(Problem &problem, const int capacity = 4);
+
+        void init(const TVector &x0) override;
+
+        Scalar value(const TVector &x) override;
+        void gradient(const TVector &x, TVector &grad) override;
+        void value_and_gradient(const TVector &x, Scalar &f, TVector &grad) override;
+
+        void hessian(const TVector &x, TMatrix &hessian) override { problem.hessian(x, hessian); }
+        void hessian(const TVector &x, THessian &hessian) override { problem.hessian(x, hessian); }
+        bool hessian_pattern(THessian &pattern) override { return problem.hessian_pattern(pattern); }
+        void hessian_values(const TVector &x, Eigen::Ref<Eigen::VectorXd> values) override { problem.hessian_values(x, values); }
+        void hessian_vector_product(const TVector &x, const TVector &v, TVector &hv) override { problem.hessian_vector_product(x, v, hv); }
+        bool hessian_preconditioner(const TVector &x, THessian &preconditioner) override { return problem.hessian_preconditioner(x, preconditioner); }
+
+        bool is_step_valid(const TVector &x0, const TVector &x1) override { return problem.is_step_valid(x0, x1); }
+        double max_step_size(const TVector &x0, const TVector &x1) override { return problem.max_step_size(x0, x1); }
+
+        void line_search_begin(const TVector &x0, const TVector &x1) override;
+        void line_search_end() override { problem.line_search_end(); }
+        void post_step(const PostStepData &data) override;
+        void set_project_to_psd(bool val) override { problem.set_project_to_psd(val); }
+        void solution_changed(const TVector &new_x) override { problem.solution_changed(new_x); }
+
+        bool after_line_search_custom_operation(const TVector &x0, const TVector &x1) override;
+        bool callbacks_change_energy() const override { return problem.callbacks_change_energy(); }
+
+        void value_batch(
+            const TVector &x,
+            const TVector &direction,
+            const Eigen::VectorXd &alphas,
+            Eigen::VectorXd &fs,
+            Eigen::VectorXi &valid) override;
+
+        bool callback(const Criteria &state, const TVector &x) override { return problem.callback(state, x); }
+        bool stop(const TVector &x) override { return problem.stop(x); }
+
+        /// @brief Forget every cached evaluation.
+        void clear();
+
+        /// @brief Number of value and gradient evaluations answered from the cache.
+        int hits() const { return m_hits; }
+
+        /// @brief Number of value and gradient evaluations forwarded to the problem
+        /// (a joint value and gradient, or a point of a batch, counts as one).
+        int evaluations() const { return m_evaluations; }
+
+    private:
+        struct Entry
+        {
+            size_t hash;
+            TVector x;
+            bool has_value = false;
+            Scalar value;
+            bool has_gradient = false;
+            TVector gradient;
+        };
+
+        /// @brief Find the entry of x and move it to the front, nullptr if x is not cached.
+        Entry *find(const TVector &x, const size_t hash);
+        /// @brief Find or create the entry of x, evicting the least recently used one.
+        Entry &insert(const TVector &x, const size_t hash);
+
+        static size_t hash_of(const TVector &x);
+
+        Problem &problem;
+        const int capacity;
+        std::vector<Entry> entries; ///< Most recently used first
+        int m_hits = 0;
+        int m_evaluations = 0;
+    };
+} // namespace polysolve::nonlinear
@@ -25,6 +25,8 @@ namespace polysolve::nonlinear
         firstGradNorm = 0;
         fDeltaCount = 0;
         xDeltaDotGrad = 0;
+        time = 0;
+        evaluations = 0;
     }
 
     void Criteria::print(std::ostream &os) const
@@ -37,12 +39,22 @@ namespace polysolve::nonlinear
             iterations, fDelta, gradNorm, xDelta, xDeltaDotGrad);
     }
 
+    bool budget_exhausted(const Criteria &stop, const Criteria &current)
+    {
+        return (stop.time > 0 && current.time >= stop.time)
+               || (stop.evaluations > 0 && current.evaluations >= stop.evaluations);
+    }
+
     Status checkConvergence(const Criteria &stop, const Criteria &current)
     {
         if (stop.iterations > 0 && current.iterations > stop.iterations)
         {
             return Status::IterationLimit;
         }
+        if (budget_exhausted(stop, current))
+        {
+            return Status::BudgetExhausted;
+        }
         const double stopGradNorm = current.iterations == 0 ? stop.firstGradNorm : stop.gradNorm;
         if (stopGradNorm > 0 && current.gradNorm < stopGradNorm)
         {
@@ -89,6 +101,10 @@ namespace polysolve::nonlinear
             return "Line search failed";
         case Status::UpdateDirectionFailed:
             return "Update direction could not be computed";
+        case Status::BudgetExhausted:
+            return "Time or evaluation budget exhausted";
+        case Status::Cancelled:
+            return "Solve cancelled";
         default:
             return "Unknown status";
         }
@@ -24,6 +24,9 @@ namespace polysolve::nonlinear
         NotDescentDirection,   ///< The search direction is not a descent direction
         LineSearchFailed,      ///< The line search failed
         UpdateDirectionFailed, ///< The update direction could not be computed
+        // Interruptions
+        BudgetExhausted, ///< The time or evaluation budget has been used up
+        Cancelled,       ///< The cancellation token was triggered
     };
 
     bool is_converged_status(const Status s);
@@ -38,6 +41,8 @@ namespace polysolve::nonlinear
         double firstGradNorm; ///< Initial norm of gradient vector
         double xDeltaDotGrad; ///< Dot product of parameter vector and gradient vector
         unsigned fDeltaCount; ///< Number of steps where fDelta is satisfied
+        double time;          ///< Wall time budget in seconds (0 for no limit)
+        size_t evaluations;   ///< Budget of value and gradient evaluations (0 for no limit)
 
         Criteria();
 
@@ -49,6 +54,9 @@ namespace polysolve::nonlinear
 
     Status checkConvergence(const Criteria &stop, const Criteria &current);
 
+    /// @brief True if the time or evaluation budget of stop is used up by current.
+    bool budget_exhausted(const Criteria &stop, const Criteria &current);
+
     std::string_view status_message(Status s);
     std::string criteria_message(const Criteria& s);
 
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <stdexcept>
+
+namespace polysolve::nonlinear
+{
+    /// @brief Base of the tiny dense problems minimized by FixedSolver<N>, whose vectors and
+    /// matrices have a compile-time size and live on the stack.
+    ///
+    /// FixedSolver is templated on the problem type, so the methods are not virtual and
+    /// get inlined. A problem must define
+    ///     Scalar value(const TVector &x);
+    ///     void gradient(const TVector &x, TVector &grad);
+    /// and, to be minimized with Newton,
+    ///     void hessian(const TVector &x, TMatrix &hessian);
+    /// The other methods have defaults which the problem can hide.
+    template <int N>
+    class FixedProblem
+    {
+        static_assert(N > 0, "FixedProblem needs a compile-time size");
+
+    public:
+        using Scalar = double;
+        static constexpr int Dim = N;
+        using TVector = Eigen::Matrix<Scalar, Dim, 1>;
+        using TMatrix = Eigen::Matrix<Scalar, Dim, Dim>;
+
+        /// @brief Compute the Hessian, only used by Newton.
+        void hessian(const TVector &x, TMatrix &hessian)
+        {
+            throw std::runtime_error("Dense Hessian not implemented.");
+        }
+
+        /// @brief Determine if the solver should stop, checked after each step.
+        bool stop(const TVector &x) { return false; }
+    };
+} // namespace polysolve::nonlinear
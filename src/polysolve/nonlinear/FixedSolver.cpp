@@ -0,0 +1,89 @@
+#include "FixedSolver.hpp"
+
+#include "Solver.hpp"
+
+#include <polysolve/Utils.hpp>
+
+namespace polysolve::nonlinear
+{
+    json FixedSolverBase::validate(const json &solver_params_in,
+                                   spdlog::logger &logger,
+                                   const bool strict_validation)
+    {
+        json solver_params = Solver::validate_params(solver_params_in, logger, strict_validation);
+
+        if (!solver_params["solver"].is_string())
+            log_and_throw_error(logger, "FixedSolver takes a single solver, not a list");
+
+        return solver_params;
+    }
+
+    std::vector<std::string> FixedSolverBase::available_solvers()
+    {
+        return {"Newton", "BFGS", "GradientDescent"};
+    }
+
+    FixedSolverBase::FixedSolverBase(const json &solver_params,
+                                     const double characteristic_length,
+                                     spdlog::logger &logger)
+        : m_logger(logger)
+    {
+        const std::string solver_name = solver_params["solver"];
+        if (solver_name == "Newton" || solver_name == "DenseNewton" || solver_name == "newton" || solver_name == "dense_newton")
+            m_strategy = Strategy::Newton;
+        else if (solver_name == "BFGS" || solver_name == "bfgs")
+            m_strategy = Strategy::BFGS;
+        else if (solver_name == "GradientDescent" || solver_name == "gradient_descent")
+            m_strategy = Strategy::GradientDescent;
+        else
+            log_and_throw_error(logger, "FixedSolver only supports Newton, BFGS, and GradientDescent, instead got {}", solver_name);
+
+        m_reg_weight_min = solver_params["Newton"]["reg_weight_min"];
+        m_reg_weight_max = solver_params["Newton"]["reg_weight_max"];
+        m_reg_weight_inc = solver_params["Newton"]["reg_weight_inc"];
+
+        m_armijo_c = solver_params["line_search"]["Armijo"]["c"];
+        m_step_ratio = solver_params["line_search"]["step_ratio"];
+        m_max_step_size_iter = solver_params["line_search"]["max_step_size_iter"];
+
+        // Same criteria as Solver
+        m_current.reset();
+
+        m_stop.xDelta = solver_params["x_delta"];
+        m_stop.fDelta = solver_params["advanced"]["f_delta"];
+        m_stop.gradNorm = solver_params["grad_norm"];
+        m_stop.firstGradNorm = solver_params["first_grad_norm_tol"];
+        m_stop.xDeltaDotGrad = -solver_params["advanced"]["derivative_along_delta_x_tol"].get<double>();
+
+        m_stop.xDelta *= characteristic_length;
+        m_stop.fDelta *= characteristic_length;
+        m_stop.gradNorm *= characteristic_length;
+        m_stop.firstGradNorm *= characteristic_length;
+
+        m_stop.iterations = solver_params["max_iterations"];
+        allow_out_of_iterations = solver_params["allow_out_of_iterations"];
+
+        m_stop.fDeltaCount = solver_params["advanced"]["f_delta_step_tol"];
+    }
+
+    std::string FixedSolverBase::name() const
+    {
+        switch (m_strategy)
+        {
+        case Strategy::Newton:
+            return "FixedNewton";
+        case Strategy::BFGS:
+            return "FixedBFGS";
+        case Strategy::GradientDescent:
+        default:
+            return "FixedGradientDescent";
+        }
+    }
+
+    void FixedSolverBase::throw_status_error() const
+    {
+        if (m_status == Status::IterationLimit)
+            log_and_throw_error(m_logger, "[{}] Reached iteration limit (limit={})", name(), m_stop.iterations);
+        log_and_throw_error(m_logger, "[{}] {} ({}); stopping", name(), status_message(m_status), m_current.print_message());
+    }
+} // namespace polysolve::nonlinear
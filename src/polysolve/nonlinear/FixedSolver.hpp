@@ -0,0 +1,307 @@
+#pragma once
+
+#include "Criteria.hpp"
+#include "FixedProblem.hpp"
+
+#include <polysolve/Types.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace spdlog
+{
+    class logger;
+}
+
+namespace polysolve::nonlinear
+{
+    /// @brief Size independent part of FixedSolver: the parameters, read once from the json,
+    /// and the stopping criteria.
+    class FixedSolverBase
+    {
+    public:
+        enum class Strategy
+        {
+            Newton,
+            BFGS,
+            GradientDescent
+        };
+
+        /// @brief Validate the parameters with the nonlinear solver spec and inject the defaults.
+        /// The result can be used to construct any number of solvers without validating again.
+        static json validate(const json &solver_params,
+                             spdlog::logger &logger,
+                             const bool strict_validation = true);
+
+        /// @brief List available solvers
+        static std::vector<std::string> available_solvers();
+
+        /// @param solver_params Parameters returned by validate
+        FixedSolverBase(const json &solver_params,
+                        const double characteristic_length,
+                        spdlog::logger &logger);
+
+        Criteria &stop_criteria() { return m_stop; }
+        const Criteria &stop_criteria() const { return m_stop; }
+        const Criteria &current_criteria() const { return m_current; }
+        Status status() const { return m_status; }
+
+        std::string name() const;
+
+        /// @brief If true the solver will not throw an error if the maximum number of iterations is reached
+        bool allow_out_of_iterations = false;
+
+    protected:
+        /// @brief Log and throw the error of the current status
+        [[noreturn]] void throw_status_error() const;
+
+        Strategy m_strategy;
+
+        // Newton regularization
+        double m_reg_weight_min;
+        double m_reg_weight_max;
+        double m_reg_weight_inc;
+
+        // Line search
+        double m_armijo_c;
+        double m_step_ratio;
+        int m_max_step_size_iter;
+
+        Criteria m_stop;
+        Criteria m_current;
+        Status m_status = Status::NotStarted;
+
+        spdlog::logger &m_logger;
+    };
+
+    /// @brief Newton, BFGS, or gradient descent with a backtracking Armijo line search on problems
+    /// with N dofs. Everything is sized at compile time: there is no heap allocation, virtual call,
+    /// or json lookup in minimize. As in Solver, an indefinite Newton Hessian is regularized, a failed
+    /// Newton or BFGS iteration is retried with gradient descent, and the solver throws on NaNs or
+    /// when gradient descent fails.
+    template <int N>
+    class FixedSolver : public FixedSolverBase
+    {
+    public:
+        using Scalar = double;
+        using TVector = typename FixedProblem<N>::TVector;
+        using TMatrix = typename FixedProblem<N>::TMatrix;
+
+        using FixedSolverBase::FixedSolverBase;
+
+        /// @brief Minimize the objective function
+        /// @param problem Objective function, following the interface of FixedProblem<N>
+        /// @param x Initial guess
+        template <typename ProblemType>
+        void minimize(ProblemType &problem, TVector &x);
+
+    private:
+        /// @brief Direction of the strategy, false if it failed
+        template <typename ProblemType>
+        bool compute_update_direction(
+            ProblemType &problem, const Strategy strategy,
+            const TVector &x, const TVector &grad, TVector &direction);
+
+        /// @brief Backtracking Armijo line search, NaN if it failed
+        template <typename ProblemType>
+        Scalar line_search(ProblemType &problem, const TVector &x, const TVector &direction,
+                           const Scalar energy, const Scalar grad_dot_direction) const;
+
+        /// @brief Inverse BFGS update with s = x - prev_x and y = grad - prev_grad
+        void update_inverse_hessian(const TVector &s, const TVector &y);
+
+        TMatrix m_inverse_hessian;
+        bool m_initial_hessian;
+    };
+
+    template <int N>
+    template <typename ProblemType>
+    void FixedSolver<N>::minimize(ProblemType &problem, TVector &x)
+    {
+        constexpr Scalar NaN = std::numeric_limits<Scalar>::quiet_NaN();
+
+        m_current.reset();
+        m_status = Status::Continue;
+
+        m_inverse_hessian.setIdentity();
+        m_initial_hessian = true;
+
+        TVector grad, prev_x, prev_grad, direction;
+        Scalar old_energy = NaN;
+
+        while (true)
+        {
+            // --- Energy and gradient -----------------------------------------
+
+            const Scalar energy = problem.value(x);
+            if (!std::isfinite(energy))
+            {
+                m_status = Status::NanEncountered;
+                throw_status_error();
+            }
+            problem.gradient(x, grad);
+
+            m_current.fDelta = std::abs(old_energy - energy);
+            m_current.gradNorm = grad.norm();
+            if (std::isnan(m_current.gradNorm))
+            {
+                m_status = Status::NanEncountered;
+                throw_status_error();
+            }
+
+            if (m_strategy == Strategy::BFGS && m_current.iterations > 0)
+                update_inverse_hessian(x - prev_x, grad - prev_grad);
+
+            // Check convergence without these values, as in Solver
+            m_current.xDelta = NaN;
+            m_current.xDeltaDotGrad = NaN;
+            m_status = checkConvergence(m_stop, m_current);
+            if (m_status != Status::Continue)
+                break;
+
+            // --- Update direction and line search ----------------------------
+
+            Scalar rate = NaN;
+            for (Strategy strategy = m_strategy;; strategy = Strategy::GradientDescent)
+            {
+                const bool is_last = strategy == Strategy::GradientDescent;
+
+                if (compute_update_direction(problem, strategy, x, grad, direction))
+                {
+                    m_current.xDelta = direction.norm();
+                    m_current.xDeltaDotGrad = direction.dot(grad);
+
+                    if (m_current.gradNorm == 0 || m_current.xDeltaDotGrad < 0)
+                    {
+                        m_status = checkConvergence(m_stop, m_current);
+                        if (m_status != Status::Continue)
+                            break;
+
+                        rate = line_search(problem, x, direction, energy, m_current.xDeltaDotGrad);
+                        if (!std::isnan(rate))
+                            break;
+
+                        if (is_last)
+                            m_status = Status::LineSearchFailed;
+                    }
+                    else if (is_last)
+                    {
+                        m_status = Status::NotDescentDirection;
+                    }
+                }
+                else if (is_last)
+                {
+                    m_status = Status::UpdateDirectionFailed;
+                }
+
+                if (is_last)
+                    throw_status_error();
+
+                // The quasi-Newton approximation led to a bad direction, start over
+                m_inverse_hessian.setIdentity();
+                m_initial_hessian = true;
+            }
+
+            if (m_status != Status::Continue)
+                break;
+
+            // --- Variable update ---------------------------------------------
+
+            prev_x = x;
+            prev_grad = grad;
+            x += rate * direction;
+            old_energy = energy;
+
+            if (problem.stop(x))
+                m_status = Status::ObjectiveCustomStop;
+
+            m_current.fDeltaCount = (m_current.fDelta < m_stop.fDelta) ? (m_current.fDeltaCount + 1) : 0;
+
+            if (++m_current.iterations >= m_stop.iterations)
+                m_status = Status::IterationLimit;
+
+            if (m_status != Status::Continue)
+                break;
+        }
+
+        if (!allow_out_of_iterations && m_status == Status::IterationLimit)
+            throw_status_error();
+    }
+
+    template <int N>
+    template <typename ProblemType>
+    bool FixedSolver<N>::compute_update_direction(
+        ProblemType &problem, const Strategy strategy,
+        const TVector &x, const TVector &grad, TVector &direction)
+    {
+        switch (strategy)
+        {
+        case Strategy::Newton:
+        {
+            TMatrix hessian;
+            problem.hessian(x, hessian);
+            Eigen::LLT<TMatrix> llt(hessian);
+
+            // Regularize H + wI with an increasing weight until it is positive definite
+            for (double reg_weight = m_reg_weight_min;
+                 llt.info() != Eigen::Success && reg_weight <= m_reg_weight_max;
+                 reg_weight *= m_reg_weight_inc)
+            {
+                llt.compute(hessian + reg_weight * TMatrix::Identity());
+            }
+
+            if (llt.info() != Eigen::Success)
+                return false;
+            direction = llt.solve(-grad);
+            return std::isfinite(direction.squaredNorm());
+        }
+        case Strategy::BFGS:
+            direction.noalias() = -m_inverse_hessian * grad;
+            return true;
+        case Strategy::GradientDescent:
+        default:
+            direction = -grad;
+            return true;
+        }
+    }
+
+    template <int N>
+    template <typename ProblemType>
+    typename FixedSolver<N>::Scalar FixedSolver<N>::line_search(
+        ProblemType &problem, const TVector &x, const TVector &direction,
+        const Scalar energy, const Scalar grad_dot_direction) const
+    {
+        Scalar rate = 1;
+        for (int i = 0; i < m_max_step_size_iter; ++i)
+        {
+            const Scalar new_energy = problem.value(x + rate * direction);
+            if (std::isfinite(new_energy) && new_energy <= energy + m_armijo_c * rate * grad_dot_direction)
+                return rate;
+            rate *= m_step_ratio;
+        }
+        return std::numeric_limits<Scalar>::quiet_NaN();
+    }
+
+    template <int N>
+    void FixedSolver<N>::update_inverse_hessian(const TVector &s, const TVector &y)
+    {
+        const Scalar y_s = y.dot(s);
+        if (!(y_s > 0))
+            return;
+
+        // Scale the initial identity before the first update (Nocedal and Wright, eq. 6.20)
+        if (m_initial_hessian)
+        {
+            m_inverse_hessian.diagonal().setConstant(y_s / y.squaredNorm());
+            m_initial_hessian = false;
+        }
+
+        // H⁺ = H - ρ(s(Hy)ᵀ + (Hy)sᵀ) + (ρ + ρ² yᵀHy) ssᵀ
+        const Scalar rho = 1 / y_s;
+        const TVector Hy = m_inverse_hessian * y;
+        const Scalar yHy = y.dot(Hy);
+
+        m_inverse_hessian -= rho * (s * Hy.transpose() + Hy * s.transpose());
+        m_inverse_hessian += (rho + rho * rho * yHy) * (s * s.transpose());
+    }
+} // namespace polysolve::nonlinear
@@ -0,0 +1,224 @@
+#include "MultiStartSolver.hpp"
+
+#include "PostStepData.hpp"
+#include "Solver.hpp"
+
+#include <polysolve/Utils.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace polysolve::nonlinear
+{
+    namespace
+    {
+        /// Problem forwarding to the problem of a run, which asks the solver to stop
+        /// once the run is dominated by the best converged run.
+        class PrunedProblem : public Problem
+        {
+        public:
+            PrunedProblem(Problem &problem,
+                          const std::atomic<double> &incumbent,
+                          const int prune_after_iterations,
+                          const double prune_tolerance)
+                : problem(problem),
+                  incumbent(incumbent),
+                  prune_after_iterations(prune_after_iterations),
+                  prune_tolerance(prune_tolerance)
+            {
+            }
+
+            void init(const TVector &x0) override { problem.init(x0); }
+
+            Scalar value(const TVector &x) override { return problem.value(x); }
+            void gradient(const TVector &x, TVector &grad) override { problem.gradient(x, grad); }
+            void value_and_gradient(const TVector &x, Scalar &f, TVector &grad) override { problem.value_and_gradient(x, f, grad); }
+
+            void hessian(const TVector &x, TMatrix &hessian) override { problem.hessian(x, hessian); }
+            void hessian(const TVector &x, THessian &hessian) override { problem.hessian(x, hessian); }
+            bool hessian_pattern(THessian &pattern) override { return problem.hessian_pattern(pattern); }
+            void hessian_values(const TVector &x, Eigen::Ref<Eigen::VectorXd> values) override { problem.hessian_values(x, values); }
+            void hessian_vector_product(const TVector &x, const TVector &v, TVector &hv) override { problem.hessian_vector_product(x, v, hv); }
+            bool hessian_preconditioner(const TVector &x, THessian &preconditioner) override { return problem.hessian_preconditioner(x, preconditioner); }
+
+            bool is_step_valid(const TVector &x0, const TVector &x1) override { return problem.is_step_valid(x0, x1); }
+            double max_step_size(const TVector &x0, const TVector &x1) override { return problem.max_step_size(x0, x1); }
+
+            void line_search_begin(const TVector &x0, const TVector &x1) override { problem.line_search_begin(x0, x1); }
+            void line_search_end() override { problem.line_search_end(); }
+            void set_project_to_psd(bool val) override { problem.set_project_to_psd(val); }
+            void solution_changed(const TVector &new_x) override { problem.solution_changed(new_x); }
+
+            bool after_line_search_custom_operation(const TVector &x0, const TVector &x1) override
+            {
+                return problem.after_line_search_custom_operation(x0, x1);
+            }
+            bool callbacks_change_energy() const override { return problem.callbacks_change_energy(); }
+
+            void value_batch(
+                const TVector &x,
+                const TVector &direction,
+                const Eigen::VectorXd &alphas,
+                Eigen::VectorXd &fs,
+                Eigen::VectorXi &valid) override
+            {
+                problem.value_batch(x, direction, alphas, fs, valid);
+            }
+
+            bool callback(const Criteria &state, const TVector &x) override { return problem.callback(state, x); }
+
+            void post_step(const PostStepData &data) override
+            {
+                iterations = data.iter_num;
+                energy = data.record ? data.record->energy : data.solver_info["energy"].get<double>();
+                problem.post_step(data);
+            }
+
+            bool stop(const TVector &x) override
+            {
+                if (prune_after_iterations > 0 && iterations >= prune_after_iterations)
+                {
+                    const double best = incumbent.load();
+                    if (energy > best + prune_tolerance * std::max(1.0, std::abs(best)))
+                    {
+                        pruned = true;
+                        return true;
+                    }
+                }
+                return problem.stop(x);
+            }
+
+            bool pruned = false;
+
+        private:
+            Problem &problem;
+            const std::atomic<double> &incumbent;
+            const int prune_after_iterations;
+            const double prune_tolerance;
+
+            int iterations = 0;
+            double energy = std::numeric_limits<double>::infinity();
+        };
+    } // namespace
+
+    std::unique_ptr<MultiStartSolver> MultiStartSolver::create(
+        const json &solver_params_in,
+        const json &linear_solver_params,
+        const double characteristic_length,
+        spdlog::logger &logger,
+        const bool strict_validation)
+    {
+        json solver_params = Solver::validate_params(solver_params_in, logger, strict_validation);
+
+        return std::make_unique<MultiStartSolver>(solver_params, linear_solver_params, characteristic_length, logger);
+    }
+
+    MultiStartSolver::MultiStartSolver(const json &solver_params,
+                                       const json &linear_solver_params,
+                                       const double characteristic_length,
+                                       spdlog::logger &logger)
+        : m_solver_params(solver_params),
+          m_linear_solver_params(linear_solver_params),
+          m_characteristic_length(characteristic_length),
+          m_logger(logger)
+    {
+        const json &params = solver_params["multi_start"];
+        m_num_threads = params["num_threads"];
+        m_prune_after_iterations = params["prune_after_iterations"];
+        m_prune_tolerance = params["prune_tolerance"];
+
+        if (m_num_threads <= 0)
+            m_num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<MultiStartSolver::Result> MultiStartSolver::minimize(
+        const ProblemFactory &factory, const std::vector<TVector> &x0s)
+    {
+        constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+        const int n_starts = x0s.size();
+        std::vector<Result> results(n_starts);
+
+        // Best energy of the converged runs, the bound used to prune the others
+        std::atomic<double> incumbent(std::numeric_limits<double>::infinity());
+        std::atomic<int> next_start(0);
+
+        const auto run = [&](const int start) {
+            Result &result = results[start];
+            result.start = start;
+            result.x = x0s[start];
+            result.energy = NaN;
+            result.status = Status::NotStarted;
+
+            // Exceptions must not escape the worker threads
+            std::unique_ptr<Problem> problem;
+            std::unique_ptr<PrunedProblem> pruned_problem;
+            std::unique_ptr<Solver> solver;
+            try
+            {
+                problem = factory(start);
+                pruned_problem = std::make_unique<PrunedProblem>(*problem, incumbent, m_prune_after_iterations, m_prune_tolerance);
+                solver = Solver::create(m_solver_params, m_linear_solver_params, m_characteristic_length, m_logger);
+                solver->minimize(*pruned_problem, result.x);
+            }
+            catch (const std::exception &e)
+            {
+                result.error = e.what();
+            }
+
+            if (pruned_problem)
+                result.pruned = pruned_problem->pruned;
+            if (solver)
+            {
+                result.status = solver->status();
+                result.info = solver->info();
+            }
+
+            if (!result.error.empty())
+                return;
+
+            result.energy = result.info["energy"];
+
+            if (!result.pruned && is_converged_status(result.status))
+            {
+                double best = incumbent.load();
+                while (result.energy < best && !incumbent.compare_exchange_weak(best, result.energy))
+                    ;
+            }
+
+            m_logger.debug("[MultiStart] start {} finished: {} f={:g}{}",
+                           start, status_message(result.status), result.energy, result.pruned ? " (pruned)" : "");
+        };
+
+        const auto worker = [&]() {
+            for (int start = next_start++; start < n_starts; start = next_start++)
+                run(start);
+        };
+
+        const int n_threads = std::min(m_num_threads, n_starts);
+        std::vector<std::thread> threads;
+        threads.reserve(std::max(0, n_threads - 1));
+        for (int t = 1; t < n_threads; ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (std::thread &t : threads)
+            t.join();
+
+        // Successful runs first, then pruned ones, then the failures
+        const auto rank = [](const Result &r) { return r.error.empty() ? (r.pruned ? 1 : 0) : 2; };
+        std::stable_sort(results.begin(), results.end(), [&](const Result &a, const Result &b) {
+            if (rank(a) != rank(b))
+                return rank(a) < rank(b);
+            return rank(a) < 2 && a.energy < b.energy;
+        });
+
+        if (n_starts > 0)
+            m_logger.info("[MultiStart] {} starts on {} threads, best f={:g} from start {}",
+                          n_starts, n_threads, results[0].energy, results[0].start);
+
+        return results;
+    }
+} // namespace polysolve::nonlinear
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Criteria.hpp"
+#include "Problem.hpp"
+
+#include <functional>
+
+namespace spdlog
+{
+    class logger;
+}
+
+namespace polysolve::nonlinear
+{
+    /// @brief Minimizes a problem from several initial guesses, running independent
+    /// Solver instances on a pool of threads. Runs whose energy stays worse than the
+    /// best converged run are stopped early (see multi_start/prune_after_iterations).
+    /// The logger is shared by all the runs, so its sinks must be thread-safe (_mt).
+    class MultiStartSolver
+    {
+    public:
+        using TVector = typename Problem::TVector;
+
+        /// @brief Create the problem of a run. It is called once per initial guess, from the
+        /// worker thread, and each run owns its problem, so problems do not need to be thread-safe.
+        using ProblemFactory = std::function<std::unique_ptr<Problem>(const int start)>;
+
+        struct Result
+        {
+            int start;             ///< Index of the initial guess
+            TVector x;             ///< Last iterate
+            double energy;         ///< Energy at x, NaN if the run failed
+            Status status;         ///< Status of the solver
+            bool pruned = false;   ///< Stopped because it was dominated by a better run
+            std::string error;     ///< Message of the exception thrown by the solver, if any
+            json info;             ///< Solver::info() of the run
+        };
+
+        /// @brief Static constructor, the parameters are validated with the nonlinear solver spec
+        static std::unique_ptr<MultiStartSolver> create(
+            const json &solver_params,
+            const json &linear_solver_params,
+            const double characteristic_length,
+            spdlog::logger &logger,
+            const bool strict_validation = true);
+
+        MultiStartSolver(const json &solver_params,
+                         const json &linear_solver_params,
+                         const double characteristic_length,
+                         spdlog::logger &logger);
+
+        /// @brief Minimize from every initial guess
+        /// @param factory Creates the problem of each run
+        /// @param x0s Initial guesses
+        /// @return One result per initial guess, the successful runs first by increasing energy
+        std::vector<Result> minimize(const ProblemFactory &factory, const std::vector<TVector> &x0s);
+
+        int num_threads() const { return m_num_threads; }
+
+    private:
+        json m_solver_params;
+        json m_linear_solver_params;
+        double m_characteristic_length;
+        spdlog::logger &m_logger;
+
+        int m_num_threads;
+        int m_prune_after_iterations;
+        double m_prune_tolerance;
+    };
+} // namespace polysolve::nonlinear
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace polysolve::nonlinear
+{
+    /// Counter-based random number generator Philox4x32-10 from
+    /// "Parallel random numbers: as easy as 1, 2, 3" (Salmon et al. 2011).
+    /// The numbers are a pure function of the key and the counter, so any
+    /// entry of a random sequence can be computed independently, in any
+    /// order and by any thread.
+    class Philox
+    {
+    public:
+        using Counter = std::array<uint32_t, 4>;
+
+        explicit Philox(const uint64_t seed)
+            : key{{uint32_t(seed), uint32_t(seed >> 32)}}
+        {
+        }
+
+        /// Four independent uniformly distributed 32 bits integers
+        Counter operator()(Counter counter) const
+        {
+            std::array<uint32_t, 2> k = key;
+            for (int round = 0; round < 10; ++round)
+            {
+                const uint64_t p0 = uint64_t(0xD2511F53) * counter[0];
+                const uint64_t p1 = uint64_t(0xCD9E8D57) * counter[2];
+                counter = {{uint32_t(p1 >> 32) ^ counter[1] ^ k[0], uint32_t(p1),
+                            uint32_t(p0 >> 32) ^ counter[3] ^ k[1], uint32_t(p0)}};
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+            return counter;
+        }
+
+        /// Random integers of the entries 4 * index to 4 * index + 3 of the sequence stream
+        Counter operator()(const uint64_t index, const uint64_t stream) const
+        {
+            return (*this)({{uint32_t(index), uint32_t(index >> 32), uint32_t(stream), uint32_t(stream >> 32)}});
+        }
+
+        /// Threshold t such that a random integer r < t with the given probability
+        static uint64_t threshold(const double probability)
+        {
+            if (!(probability > 0))
+                return 0;
+            if (probability >= 1)
+                return uint64_t(1) << 32;
+            return uint64_t(probability * 4294967296.0);
+        }
+
+    private:
+        std::array<uint32_t, 2> key;
+    };
+} // namespace polysolve::nonlinear
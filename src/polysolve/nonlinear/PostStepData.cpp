@@ -1,12 +1,16 @@
 #include "PostStepData.hpp"
 
+#include <utility>
+
 namespace polysolve::nonlinear
 {
     PostStepData::PostStepData(const int iter_num,
                                const json &solver_info,
                                const Eigen::VectorXd &x,
-                               const Eigen::VectorXd &grad)
-        : iter_num(iter_num), solver_info(solver_info), x(x), grad(grad)
+                               const Eigen::VectorXd &grad,
+                               const IterationRecord *record,
+                               std::function<const json &()> full_info)
+        : iter_num(iter_num), solver_info(solver_info), x(x), grad(grad), record(record), full_info(std::move(full_info))
     {
     }
 } // namespace polysolve::nonlinear
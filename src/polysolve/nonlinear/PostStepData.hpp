@@ -1,6 +1,9 @@
 #pragma once
 
 #include <polysolve/Types.hpp>
+#include "Telemetry.hpp"
+
+#include <functional>
 
 namespace polysolve::nonlinear
 {
@@ -11,11 +14,22 @@ namespace polysolve::nonlinear
         PostStepData(const int iter_num,
                      const json &solver_info,
                      const Eigen::VectorXd &x,
-                     const Eigen::VectorXd &grad);
+                     const Eigen::VectorXd &grad,
+                     const IterationRecord *record = nullptr,
+                     std::function<const json &()> full_info = nullptr);
+
+        /// @brief Complete solver info (strategies and line search included), only gathered when called
+        const json &info() const { return full_info ? full_info() : solver_info; }
 
         const int iter_num;
+        /// Scalar fields of the solver info (status, energy, norms and times), see info() for the rest
         const json &solver_info;
         const Eigen::VectorXd &x;
         const Eigen::VectorXd &grad;
+        /// Telemetry of the iteration, nullptr before the first one
+        const IterationRecord *record;
+
+    private:
+        std::function<const json &()> full_info;
     };
 } // namespace polysolve::nonlinear
@@ -1,7 +1,37 @@
 #include "Problem.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace polysolve::nonlinear
 {
+    void Problem::hessian_vector_product(const TVector &x, const TVector &v, TVector &hv)
+    {
+        const double v_norm = v.norm();
+        if (v_norm == 0)
+        {
+            hv.setZero(x.size());
+            return;
+        }
+
+        // Step balancing truncation and round-off errors of central differences
+        const double h = std::cbrt(std::numeric_limits<double>::epsilon()) * std::max(1.0, x.norm()) / v_norm;
+
+        TVector xh = x + h * v;
+        TVector grad_plus, grad_minus;
+        solution_changed(xh);
+        gradient(xh, grad_plus);
+
+        xh = x - h * v;
+        solution_changed(xh);
+        gradient(xh, grad_minus);
+
+        solution_changed(x);
+
+        hv = (grad_plus - grad_minus) / (2 * h);
+    }
+
     void Problem::sample_along_direction(
         const Problem::TVector &x,
         const Problem::TVector &direction,
@@ -13,19 +43,27 @@ namespace polysolve::nonlinear
         Eigen::VectorXi &valid)
     {
         alphas = Eigen::VectorXd::LinSpaced(num_samples, start, end);
+        value_batch(x, direction, alphas, fs, valid);
+    }
+
+    void Problem::value_batch(
+        const TVector &x,
+        const TVector &direction,
+        const Eigen::VectorXd &alphas,
+        Eigen::VectorXd &fs,
+        Eigen::VectorXi &valid)
+    {
         fs.resize(alphas.size());
         valid.resize(alphas.size());
 
-        Problem::TVector new_x;
+        TVector new_x;
 
         for (int i = 0; i < alphas.size(); i++)
         {
             new_x = x + alphas[i] * direction;
 
             solution_changed(new_x);
-            const double fxi = value(new_x);
-
-            fs[i] = fxi;
+            fs[i] = value(new_x);
             valid[i] = is_step_valid(x, new_x);
         }
     }
@@ -43,6 +43,17 @@ namespace polysolve::nonlinear
         /// @param[out] grad Gradient of the function at x.
         virtual void gradient(const TVector &x, TVector &grad) = 0;
 
+        /// @brief Compute the value and the gradient of the function at x.
+        /// The default calls value and gradient, problems sharing work between them should override it.
+        /// @param[in] x Degrees of freedom.
+        /// @param[out] f The value of the function at x.
+        /// @param[out] grad Gradient of the function at x.
+        virtual void value_and_gradient(const TVector &x, Scalar &f, TVector &grad)
+        {
+            f = value(x);
+            gradient(x, grad);
+        }
+
         /// @brief Compute the Hessian of the function at x.
         /// @param[in] x Degrees of freedom.
         /// @param[out] hessian Hessian of the function at x.
@@ -56,6 +67,36 @@ namespace polysolve::nonlinear
         /// @param[out] hessian Hessian of the function at x.
         virtual void hessian(const TVector &x, THessian &hessian) = 0;
 
+        /// @brief Sparsity pattern of the Hessian, which must stay the same during a minimization.
+        /// Problems providing it (and hessian_values) let the solvers refill a persistent Hessian
+        /// instead of assembling a new matrix at every iteration.
+        /// @param[out] pattern Compressed matrix with the structural nonzeros of the Hessian.
+        /// @return False if the problem does not provide one (default).
+        virtual bool hessian_pattern(THessian &pattern) { return false; }
+
+        /// @brief Compute the nonzeros of the Hessian at x in the order of hessian_pattern.
+        /// @param[in] x Degrees of freedom.
+        /// @param[out] values Values of the compressed Hessian (pattern.valuePtr()).
+        virtual void hessian_values(const TVector &x, Eigen::Ref<Eigen::VectorXd> values)
+        {
+            throw std::runtime_error("Hessian values not implemented.");
+        }
+
+        /// @brief Compute the product of the Hessian of the function at x with v, without assembling it.
+        /// The default uses central differences of the gradient, so it costs two gradient
+        /// evaluations and calls solution_changed at the perturbed points (and back at x).
+        /// @param[in] x Degrees of freedom.
+        /// @param[in] v Vector to multiply.
+        /// @param[out] hv Product of the Hessian at x with v.
+        virtual void hessian_vector_product(const TVector &x, const TVector &v, TVector &hv);
+
+        /// @brief Compute a cheap approximation of the Hessian at x, typically its diagonal or its
+        /// diagonal blocks, used to precondition matrix-free Newton.
+        /// @param[in] x Degrees of freedom.
+        /// @param[out] preconditioner Symmetric positive definite approximation of the Hessian at x.
+        /// @return False if the problem does not provide one (default).
+        virtual bool hessian_preconditioner(const TVector &x, THessian &preconditioner) { return false; }
+
         /// @brief Determine if the step from x0 to x1 is valid.
         /// @param x0 Starting point.
         /// @param x1 Ending point.
@@ -92,6 +133,29 @@ namespace polysolve::nonlinear
 
         virtual bool after_line_search_custom_operation(const TVector &x0, const TVector &x1) { return false; }
 
+        /// @brief Determine if line_search_begin or post_step can change the value or gradient
+        /// at a fixed x (e.g., a new constraint set or barrier stiffness).
+        /// The solver then forgets its cached evaluations after these callbacks.
+        /// @return True if these callbacks change the energy, false otherwise.
+        virtual bool callbacks_change_energy() const { return false; }
+
+        /// @brief Evaluate the function at several points along a direction.
+        /// The default evaluates them one after the other (solution_changed, value, is_step_valid);
+        /// problems able to evaluate several points concurrently should override it.
+        /// The state of the problem after the call is unspecified.
+        /// Exceptions thrown by solution_changed are propagated.
+        /// @param[in] x Starting point.
+        /// @param[in] direction Direction to evaluate along.
+        /// @param[in] alphas Step sizes to evaluate.
+        /// @param[out] fs Values at x + alphas[i] * direction.
+        /// @param[out] valid If each step from x is valid.
+        virtual void value_batch(
+            const TVector &x,
+            const TVector &direction,
+            const Eigen::VectorXd &alphas,
+            Eigen::VectorXd &fs,
+            Eigen::VectorXi &valid);
+
         /// @brief Callback function used to determine if the solver should stop.
         /// @param state Current state of the solver.
         /// @param x Current solution.
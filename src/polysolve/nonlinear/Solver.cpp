@@ -1,14 +1,19 @@
 
 #include "Solver.hpp"
 
+#include "CachedProblem.hpp"
 #include "PostStepData.hpp"
 
 #include "descent_strategies/BFGS.hpp"
 #include "descent_strategies/Newton.hpp"
+#include "descent_strategies/MatrixFreeNewton.hpp"
+#include "descent_strategies/TrustRegion.hpp"
 #include "descent_strategies/ADAM.hpp"
 #include "descent_strategies/GradientDescent.hpp"
 #include "descent_strategies/LBFGS.hpp"
 
+#include <polysolve/BinaryIO.hpp>
+#include <polysolve/Tracing.hpp>
 #include <polysolve/Utils.hpp>
 
 #include <jse/jse.h>
@@ -23,8 +28,12 @@
 
 #include <finitediff.hpp>
 
-#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iomanip>
+#include <optional>
 
 namespace polysolve::nonlinear
 {
@@ -77,6 +86,16 @@ namespace polysolve::nonlinear
                 return std::make_shared<RegularizedNewton>(true, true, solver_params, linear_solver_params, characteristic_length, logger);
             }
 
+            else if (solver_name == "MatrixFreeNewton")
+            {
+                return std::make_shared<MatrixFreeNewton>(solver_params, characteristic_length, logger);
+            }
+
+            else if (solver_name == "TrustRegion")
+            {
+                return std::make_shared<TrustRegion>(solver_params, linear_solver_params, characteristic_length, logger);
+            }
+
             else if (solver_name == "LBFGS" || solver_name == "L-BFGS")
             {
                 return std::make_shared<LBFGS>(solver_params, characteristic_length, logger);
@@ -111,11 +130,8 @@ namespace polysolve::nonlinear
          {FiniteDiffStrategy::DIRECTIONAL_DERIVATIVE, "DirectionalDerivative"},
          {FiniteDiffStrategy::FULL_FINITE_DIFF, "FullFiniteDiff"}})
 
-    // Static constructor
-    std::unique_ptr<Solver> Solver::create(
+    json Solver::validate_params(
         const json &solver_params_in,
-        const json &linear_solver_params,
-        const double characteristic_length,
         spdlog::logger &logger,
         const bool strict_validation)
     {
@@ -140,6 +156,19 @@ namespace polysolve::nonlinear
 
         solver_params = jse.inject_defaults(solver_params, rules);
 
+        return solver_params;
+    }
+
+    // Static constructor
+    std::unique_ptr<Solver> Solver::create(
+        const json &solver_params_in,
+        const json &linear_solver_params,
+        const double characteristic_length,
+        spdlog::logger &logger,
+        const bool strict_validation)
+    {
+        json solver_params = validate_params(solver_params_in, logger, strict_validation);
+
         auto solver = std::make_unique<Solver>(solver_params, characteristic_length, logger);
 
         if (solver_params["solver"].is_array())
@@ -188,6 +217,8 @@ namespace polysolve::nonlinear
         return {"BFGS",
                 "DenseNewton",
                 "Newton",
+                "MatrixFreeNewton",
+                "TrustRegion",
                 "ADAM",
                 "StochasticADAM",
                 "GradientDescent",
@@ -221,12 +252,33 @@ namespace polysolve::nonlinear
 
         m_stop.fDeltaCount = solver_params["advanced"]["f_delta_step_tol"];
 
+        m_stop.time = solver_params["advanced"]["max_time"];
+        m_stop.evaluations = solver_params["advanced"]["max_evaluations"];
+
         m_descent_strategy = 0;
 
         set_line_search(solver_params);
 
         gradient_fd_strategy = solver_params["advanced"]["apply_gradient_fd"];
         gradient_fd_eps = solver_params["advanced"]["gradient_fd_eps"];
+
+        cache_evaluations = solver_params["advanced"]["cache_evaluations"];
+
+        checkpoint_path = solver_params["advanced"]["checkpoint_path"];
+        checkpoint_frequency = solver_params["advanced"]["checkpoint_frequency"];
+        if (checkpoint_frequency > 0 && checkpoint_path.empty())
+            log_and_throw_error(m_logger, "checkpoint_frequency is {} but no checkpoint_path is given", checkpoint_frequency);
+
+        warm_start = solver_params["advanced"]["warm_start"];
+
+        perf_counters = solver_params["advanced"]["perf_counters"];
+        if (perf_counters && !perf::available())
+            m_logger.warn("Hardware performance counters are unavailable (see /proc/sys/kernel/perf_event_paranoid), only the phase times are reported");
+
+        m_telemetry.set_capacity(solver_params["advanced"]["telemetry_size"].get<int>());
+        const std::string telemetry_path = solver_params["advanced"]["telemetry_path"];
+        if (!telemetry_path.empty())
+            m_telemetry.open_sink(telemetry_path);
     }
 
     void Solver::set_strategies_iterations(const json &solver_params)
@@ -257,16 +309,69 @@ namespace polysolve::nonlinear
         m_line_search->use_grad_norm_tol *= characteristic_length;
     }
 
-    void Solver::minimize(Problem &objFunc, TVector &x)
+    void Solver::minimize(Problem &problem, TVector &x)
     {
         constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
 
-        int previous_strategy = m_descent_strategy;
-        int current_strategy_iter = 0;
+        const auto start_time = std::chrono::steady_clock::now();
+
+        // Points revisited by the line search and the solver are evaluated once,
+        // without a cache it only counts the evaluations for the budget
+        CachedProblem cached_problem(problem, cache_evaluations ? 4 : 0);
+        Problem &objFunc = cached_problem;
+
         // ---------------------------
         // Initialize the minimization
         // ---------------------------
-        reset(x.size()); // place for children to initialize their fields
+        if (m_resume)
+        {
+            // Continue from the checkpoint restored by load_state
+            m_resume = false;
+            if (x.size() != m_resume_ndof)
+                log_and_throw_error(m_logger, "Checkpoint has {} dofs, but x has {}", m_resume_ndof, x.size());
+            m_status = Status::NotStarted;
+        }
+        else
+        {
+            reset(x.size()); // place for children to initialize their fields
+        }
+        // Hardware events of the phases of this minimize, on the calling thread
+        std::optional<perf::Region> perf_region;
+        if (perf_counters)
+            perf_region.emplace();
+
+        // Only reused if this minimize converges
+        const int warm_ndof = x.size();
+        m_warm_ndof = -1;
+
+        // The inner loops only get a token if something can cancel it, the iterative
+        // linear solvers are restarted between the checks
+        m_interrupt->reset();
+        m_interrupt->set_parent(m_cancellation);
+        if (m_stop.time > 0)
+            m_interrupt->set_timeout(m_stop.time);
+        const std::shared_ptr<const CancellationToken> interrupt =
+            m_cancellation || m_stop.time > 0 ? m_interrupt : nullptr;
+        m_line_search->set_cancellation_token(interrupt);
+        for (auto &s : m_strategies)
+            s->set_cancellation_token(interrupt);
+
+        // Sets the status and returns true if the solve must stop with the last accepted iterate
+        const auto interrupted = [&]() {
+            m_current.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            m_current.evaluations = cached_problem.evaluations();
+            if (m_cancellation && m_cancellation->is_cancelled())
+                m_status = Status::Cancelled;
+            else if (budget_exhausted(m_stop, m_current))
+                m_status = Status::BudgetExhausted;
+            else
+                return false;
+
+            m_logger.debug("[{}][{}] {}; stopping", descent_strategy_name(), m_line_search->name(), status_message(m_status));
+            return true;
+        };
+
+        int previous_strategy = m_descent_strategy;
 
         TVector grad = TVector::Zero(x.rows());
         TVector delta_x = TVector::Zero(x.rows());
@@ -286,18 +391,27 @@ namespace polysolve::nonlinear
             descent_strategy_name(), m_line_search->name(), objFunc(x), m_stop.print_message());
 
         update_solver_info(objFunc(x));
-        objFunc.post_step(PostStepData(m_current.iterations, solver_info, x, grad));
+        objFunc.post_step(PostStepData(m_current.iterations, solver_info, x, grad, nullptr, [this]() -> const json & { return info(); }));
+
+        // Times already attributed to an iteration record
+        double recorded_obj_fun_time = obj_fun_time;
+        double recorded_update_direction_time = update_direction_time;
+        double recorded_line_search_time = line_search_time;
 
         do
         {
+            POLYSOLVE_TRACE_SCOPE("iteration");
             m_line_search->set_is_final_strategy(m_descent_strategy == m_strategies.size() - 1);
 
-            // --- Energy ------------------------------------------------------
+            if (interrupted())
+                break;
+
+            // --- Energy and gradient -----------------------------------------
 
             double energy;
             {
-                POLYSOLVE_SCOPED_STOPWATCH("compute objective function", obj_fun_time, m_logger);
-                energy = objFunc(x);
+                POLYSOLVE_SCOPED_STOPWATCH("compute objective function and gradient", obj_fun_time, m_logger);
+                objFunc.value_and_gradient(x, energy, grad);
             }
 
             if (!std::isfinite(energy))
@@ -309,14 +423,8 @@ namespace polysolve::nonlinear
 
             m_current.fDelta = std::abs(old_energy - energy);
 
-            // --- Gradient ----------------------------------------------------
-            {
-                POLYSOLVE_SCOPED_STOPWATCH("compute gradient", grad_time, m_logger);
-                objFunc.gradient(x, grad);
-            }
-
             {
-                POLYSOLVE_SCOPED_STOPWATCH("verify gradient", grad_time, m_logger);
+                POLYSOLVE_SCOPED_STOPWATCH("verify gradient", verify_gradient_time, m_logger);
                 verify_gradient(objFunc, x, grad);
             }
 
@@ -342,6 +450,10 @@ namespace polysolve::nonlinear
                 update_direction_successful = compute_update_direction(objFunc, x, grad, delta_x);
             }
 
+            // The direction of an interrupted linear solve is not trusted
+            if (interrupted())
+                break;
+
             m_current.xDelta = delta_x.norm();
             if (!update_direction_successful || std::isnan(m_current.xDelta))
             {
@@ -408,7 +520,8 @@ namespace polysolve::nonlinear
                 m_current.iterations, energy, m_current.gradNorm);
 
             // Perform a line_search to compute step scale
-            double rate;
+            double rate = 1;
+            if (m_strategies[m_descent_strategy]->uses_line_search())
             {
                 POLYSOLVE_SCOPED_STOPWATCH("line search", line_search_time, m_logger);
                 rate = m_line_search->line_search(x, delta_x, objFunc);
@@ -416,6 +529,9 @@ namespace polysolve::nonlinear
 
             if (std::isnan(rate))
             {
+                if (interrupted())
+                    break;
+
                 const auto current_name = descent_strategy_name();
                 assert(m_status == Status::Continue);
                 if (!m_strategies[m_descent_strategy]->handle_error())
@@ -440,27 +556,48 @@ namespace polysolve::nonlinear
 
             old_energy = energy;
 
+            // --- Telemetry ---------------------------------------------------
+
+            IterationRecord record;
+            record.iteration = m_current.iterations;
+            record.strategy = m_descent_strategy;
+            record.energy = energy;
+            record.grad_norm = m_current.gradNorm;
+            record.x_delta = m_current.xDelta;
+            record.f_delta = m_current.fDelta;
+            record.step_size = rate;
+            m_strategies[m_descent_strategy]->update_iteration_record(record);
+
+            record.time_obj_fun = obj_fun_time - recorded_obj_fun_time;
+            record.time_direction = update_direction_time - recorded_update_direction_time;
+            record.time_line_search = line_search_time - recorded_line_search_time;
+            recorded_obj_fun_time = obj_fun_time;
+            recorded_update_direction_time = update_direction_time;
+            recorded_line_search_time = line_search_time;
+
+            m_telemetry.push(record);
+
             // Reset this for the next iterations
             // if the strategy got changed, we start counting
             if (m_descent_strategy != previous_strategy)
-                current_strategy_iter = 0;
+                m_strategy_iter = 0;
             // if we did enough lower strategy, we revert back to normal
-            if (m_descent_strategy != 0 && current_strategy_iter >= m_iter_per_strategy[m_descent_strategy])
+            if (m_descent_strategy != 0 && m_strategy_iter >= m_iter_per_strategy[m_descent_strategy])
             {
                 const auto current_name = descent_strategy_name();
                 const std::string prev_strategy_name = descent_strategy_name();
 
                 m_descent_strategy = 0;
                 for (auto &s : m_strategies)
-                    s->reset(x.size());
+                    s->restart(x.size());
 
                 m_logger.debug(
                     "[{}][{}] {} was successful for {} iterations; resetting to {}",
-                    current_name, m_line_search->name(), prev_strategy_name, current_strategy_iter, descent_strategy_name());
+                    current_name, m_line_search->name(), prev_strategy_name, m_strategy_iter, descent_strategy_name());
             }
 
             previous_strategy = m_descent_strategy;
-            ++current_strategy_iter;
+            ++m_strategy_iter;
 
             // -----------
             // Post update
@@ -471,7 +608,7 @@ namespace polysolve::nonlinear
             //                descent_strategy_name(), m_line_search->name(), rate, step);
 
             update_solver_info(energy);
-            objFunc.post_step(PostStepData(m_current.iterations, solver_info, x, grad));
+            objFunc.post_step(PostStepData(m_current.iterations, solver_info, x, grad, &record, [this]() -> const json & { return info(); }));
 
             if (objFunc.stop(x))
             {
@@ -487,10 +624,16 @@ namespace polysolve::nonlinear
 
             if (++m_current.iterations >= m_stop.iterations)
                 m_status = Status::IterationLimit;
+
+            if (checkpoint_frequency > 0 && m_current.iterations % checkpoint_frequency == 0)
+                save_state(checkpoint_path, x);
         } while (objFunc.callback(m_current, x) && (m_status == Status::Continue));
 
         stop_watch.stop();
 
+        if (perf_region)
+            solver_info["perf_counters"] = perf_region->report();
+
         // -----------
         // Log results
         // -----------
@@ -510,30 +653,162 @@ namespace polysolve::nonlinear
 
         log_times();
         update_solver_info(objFunc(x));
+        solver_info["cached_evaluations"] = cached_problem.hits();
+        solver_info["evaluations"] = cached_problem.evaluations();
+
+        if (is_converged_status(m_status))
+            m_warm_ndof = warm_ndof;
     }
 
     void Solver::reset(const int ndof)
     {
+        // Keep the strategy that converged and the state of the strategies
+        const bool warm = warm_start && m_warm_ndof == ndof;
+        if (warm)
+            m_logger.debug("Warm starting {} with {} dofs", descent_strategy_name(), ndof);
+
         m_current.reset();
-        m_descent_strategy = 0;
+        if (!warm)
+            m_descent_strategy = 0;
+        m_strategy_iter = 0;
+        m_resume = false;
         m_status = Status::NotStarted;
 
         const std::string line_search_name = solver_info["line_search"];
         solver_info = json();
         solver_info["line_search"] = line_search_name;
         solver_info["iterations"] = 0;
+        solver_info_stale = false;
+
+        m_telemetry.clear();
 
         for (auto &s : m_strategies)
-            s->reset(ndof);
+        {
+            if (warm)
+                s->warm_start(ndof);
+            else
+                s->reset(ndof);
+        }
 
         reset_times();
     }
 
+    namespace
+    {
+        constexpr char STATE_MAGIC[8] = {'P', 'S', 'S', 'T', 'A', 'T', 'E', '\0'};
+        constexpr uint32_t STATE_VERSION = 3;
+
+        /// Name identifying a strategy in a checkpoint, without the parameters some names print
+        std::string state_name(const std::string &name)
+        {
+            return name.substr(0, name.find(" ("));
+        }
+    } // namespace
+
+    void Solver::save_state(std::ostream &out, const TVector &x) const
+    {
+        out.write(STATE_MAGIC, sizeof(STATE_MAGIC));
+        write_value(out, STATE_VERSION);
+        write_value(out, int64_t(x.size()));
+
+        write_value(out, m_current);
+        write_value(out, int32_t(m_descent_strategy));
+        write_value(out, int32_t(m_strategy_iter));
+
+        write_value(out, uint32_t(m_strategies.size()));
+        for (const auto &s : m_strategies)
+        {
+            write_value(out, state_name(s->name()));
+            s->save_state(out);
+        }
+
+        write_value(out, m_line_search->name());
+        m_line_search->save_state(out);
+
+        write_dense(out, x);
+    }
+
+    void Solver::save_state(const std::string &path, const TVector &x) const
+    {
+        // Write next to the previous checkpoint and swap, so that a preemption
+        // during the write never leaves a truncated file behind
+        const std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open())
+                log_and_throw_error(m_logger, "Unable to open checkpoint {}", tmp_path);
+            save_state(out, x);
+            if (!out)
+                log_and_throw_error(m_logger, "Unable to write checkpoint {}", tmp_path);
+        }
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+            log_and_throw_error(m_logger, "Unable to move checkpoint {} to {}", tmp_path, path);
+
+        m_logger.debug("Saved checkpoint {} at iteration {}", path, m_current.iterations);
+    }
+
+    void Solver::load_state(std::istream &in, TVector &x)
+    {
+        char magic[sizeof(STATE_MAGIC)];
+        uint32_t version = 0;
+        int64_t ndof = -1;
+        in.read(magic, sizeof(magic));
+        read_value(in, version);
+        read_value(in, ndof);
+        if (!in || std::memcmp(magic, STATE_MAGIC, sizeof(magic)) != 0 || version != STATE_VERSION || ndof < 0)
+            log_and_throw_error(m_logger, "Invalid checkpoint header");
+
+        m_warm_ndof = -1; // the strategies restore their own state
+        reset(ndof);
+
+        int32_t descent_strategy, strategy_iter;
+        uint32_t n_strategies;
+        read_value(in, m_current);
+        read_value(in, descent_strategy);
+        read_value(in, strategy_iter);
+        read_value(in, n_strategies);
+        if (!in || n_strategies != m_strategies.size() || descent_strategy < 0 || descent_strategy >= int(m_strategies.size()))
+            log_and_throw_error(m_logger, "Checkpoint has {} strategies, but the solver has {}", n_strategies, m_strategies.size());
+        m_descent_strategy = descent_strategy;
+        m_strategy_iter = strategy_iter;
+
+        std::string name;
+        for (const auto &s : m_strategies)
+        {
+            read_value(in, name);
+            if (name != state_name(s->name()))
+                log_and_throw_error(m_logger, "Checkpoint strategy {} does not match {}", name, state_name(s->name()));
+            s->load_state(in);
+        }
+
+        read_value(in, name);
+        if (name != m_line_search->name())
+            log_and_throw_error(m_logger, "Checkpoint line search {} does not match {}", name, m_line_search->name());
+        m_line_search->load_state(in);
+
+        read_dense(in, x);
+        if (!in || x.size() != ndof)
+            log_and_throw_error(m_logger, "Corrupted checkpoint");
+
+        m_resume = true;
+        m_resume_ndof = ndof;
+    }
+
+    void Solver::load_state(const std::string &path, TVector &x)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open())
+            log_and_throw_error(m_logger, "Unable to open checkpoint {}", path);
+        load_state(in, x);
+
+        m_logger.debug("Loaded checkpoint {} at iteration {}", path, m_current.iterations);
+    }
+
     void Solver::reset_times()
     {
         total_time = 0;
         obj_fun_time = 0;
-        grad_time = 0;
+        verify_gradient_time = 0;
         update_direction_time = 0;
         line_search_time = 0;
         constraint_set_update_time = 0;
@@ -555,25 +830,42 @@ namespace polysolve::nonlinear
         double per_iteration = m_current.iterations ? m_current.iterations : 1;
 
         solver_info["total_time"] = total_time;
+        // The energy and gradient are evaluated together, time_obj_fun covers both
         solver_info["time_obj_fun"] = obj_fun_time / per_iteration;
-        solver_info["time_grad"] = grad_time / per_iteration;
+        solver_info["time_verify_gradient"] = verify_gradient_time / per_iteration;
         // Do not save update_direction_time as it is redundant with the strategies
         solver_info["time_line_search"] = line_search_time / per_iteration;
         solver_info["time_constraint_set_update"] = constraint_set_update_time / per_iteration;
 
+        solver_info_stale = true;
+    }
+
+    void Solver::update_strategies_info() const
+    {
+        const double per_iteration = m_current.iterations ? m_current.iterations : 1;
+
         for (auto &s : m_strategies)
             s->update_solver_info(solver_info, per_iteration);
         if (m_line_search)
             m_line_search->update_solver_info(solver_info, per_iteration);
+
+        solver_info_stale = false;
+    }
+
+    const json &Solver::info() const
+    {
+        if (solver_info_stale)
+            update_strategies_info();
+        return solver_info;
     }
 
     void Solver::log_times() const
     {
         m_logger.debug(
-            "[{}] f: {:.2e}s, grad_f: {:.2e}s, update_direction: {:.2e}s, "
+            "[{}] f and grad_f: {:.2e}s, verify grad_f: {:.2e}s, update_direction: {:.2e}s, "
             "line_search: {:.2e}s, constraint_set_update: {:.2e}s",
             fmt::format(fmt::fg(fmt::terminal_color::magenta), "timing"),
-            obj_fun_time, grad_time, update_direction_time, line_search_time,
+            obj_fun_time, verify_gradient_time, update_direction_time, line_search_time,
             constraint_set_update_time);
         for (auto &s : m_strategies)
             s->log_times();
@@ -583,6 +875,9 @@ namespace polysolve::nonlinear
 
     void Solver::verify_gradient(Problem &objFunc, const TVector &x, const TVector &grad)
     {
+        if (gradient_fd_strategy == FiniteDiffStrategy::NONE)
+            return;
+
         bool match = false;
         double J = objFunc(x);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Criteria.hpp"
+#include "Telemetry.hpp"
 #include "descent_strategies/DescentStrategy.hpp"
 // Line search methods
 #include "line_search/LineSearch.hpp"
@@ -41,6 +42,16 @@ namespace polysolve::nonlinear
             spdlog::logger &logger,
             const bool strict_validation = true);
 
+        /// @brief Validate solver parameters against the nonlinear solver spec and inject its defaults
+        /// @param solver_params JSON of solver parameters
+        /// @param logger Logger used to report invalid parameters
+        /// @param strict_validation Reject parameters not in the spec
+        /// @return Parameters with the defaults injected
+        static json validate_params(
+            const json &solver_params,
+            spdlog::logger &logger,
+            const bool strict_validation = true);
+
         /// @brief List available solvers
         static std::vector<std::string> available_solvers();
 
@@ -77,15 +88,45 @@ namespace polysolve::nonlinear
 
         void set_strategies_iterations(const json &solver_params);
         void set_line_search(const json &params);
-        const json &info() const { return solver_info; }
+        /// @brief Solver info, the details of the strategies and line search are only gathered when it is called
+        const json &info() const;
+
+        /// @brief Records of the last iterations
+        const Telemetry &telemetry() const { return m_telemetry; }
+        Telemetry &telemetry() { return m_telemetry; }
 
         /// @brief If true the solver will not throw an error if the maximum number of iterations is reached
         bool allow_out_of_iterations = false;
 
+        /// @brief Token to stop the next minimize calls from another thread. A cancelled minimize
+        /// returns with the last accepted iterate and the status Cancelled, without throwing.
+        void set_cancellation_token(std::shared_ptr<const CancellationToken> token) { m_cancellation = std::move(token); }
+
 
         /// @brief Get the line search object
         const std::shared_ptr<line_search::LineSearch> &line_search() const { return m_line_search; };
 
+        // ====================================================================
+        //                             Checkpoints
+        // ====================================================================
+
+        /// @brief Write the criteria, the strategy index, the state of the strategies and line search, and x
+        /// @param out Binary stream
+        /// @param x Current iterate
+        void save_state(std::ostream &out, const TVector &x) const;
+
+        /// @brief Write a checkpoint file, replacing the previous one atomically
+        void save_state(const std::string &path, const TVector &x) const;
+
+        /// @brief Restore a checkpoint of a solver with the same strategies. The next
+        /// minimize continues from it (iterations, curvature history, ...) instead of starting over.
+        /// @param in Binary stream written by save_state
+        /// @param[out] x Iterate of the checkpoint
+        void load_state(std::istream &in, TVector &x);
+
+        /// @brief Restore a checkpoint file
+        void load_state(const std::string &path, TVector &x);
+
     protected:
         /// @brief Compute direction in which the argument should be updated 
         /// @param objFunc Problem to be minimized
@@ -136,6 +177,25 @@ namespace polysolve::nonlinear
 
         const double characteristic_length;
 
+        /// @brief Remember the values and gradients of the last few points (see CachedProblem)
+        bool cache_evaluations = true;
+
+        /// @brief Checkpoint written every checkpoint_frequency iterations (0 to disable)
+        std::string checkpoint_path;
+        int checkpoint_frequency = 0;
+
+        /// @brief Start from the state of the previous minimize (see DescentStrategy::warm_start)
+        bool warm_start = false;
+
+        /// @brief Report the hardware events of each phase in the info (see PerfCounters.hpp)
+        bool perf_counters = false;
+
+        /// @brief Token given by the user
+        std::shared_ptr<const CancellationToken> m_cancellation;
+        /// @brief Token of the current minimize, cancelled with the user token or once the
+        /// time budget is used up; checked by the strategies, line search, and linear solvers
+        std::shared_ptr<CancellationToken> m_interrupt = std::make_shared<CancellationToken>();
+
         // ====================================================================
         //                           Solver state
         // ====================================================================
@@ -151,26 +211,42 @@ namespace polysolve::nonlinear
 
         std::vector<int> m_iter_per_strategy;
 
+        /// @brief Number of iterations done with the current strategy
+        int m_strategy_iter = 0;
+
+        /// @brief The next minimize continues from a loaded checkpoint
+        bool m_resume = false;
+        int m_resume_ndof = 0;
+
+        /// @brief Number of dofs of the last converged minimize, -1 if its state cannot be reused
+        int m_warm_ndof = -1;
+
         // ====================================================================
         //                            Solver info
         // ====================================================================
 
-        /// @brief Update solver info JSON object
+        /// @brief Update the scalar fields of the solver info JSON object, the rest is gathered by info()
         /// @param energy 
         void update_solver_info(const double energy);
 
+        /// @brief Add the info of the strategies and line search to the solver info
+        void update_strategies_info() const;
+
         /// @brief Reset timing members to 0
         void reset_times();
 
         /// @brief Log time taken in different phases of the solve
         void log_times() const;
 
-        json solver_info;
+        mutable json solver_info;
+        mutable bool solver_info_stale = false; ///< The strategies info is outdated
+
+        Telemetry m_telemetry;
 
         // Timers
         double total_time;
-        double obj_fun_time;
-        double grad_time;
+        double obj_fun_time;         ///< Energy and gradient evaluation, fused in value_and_gradient
+        double verify_gradient_time; ///< Gradient verification against finite differences
         double update_direction_time;
         double line_search_time;
         double constraint_set_update_time;
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Problem.hpp"
+
+namespace polysolve::nonlinear
+{
+    /// @brief Problem whose objective is a sum of terms f(x) = Σᵢ fᵢ(x), minimized by the
+    /// StochasticSolver from the gradients of random mini-batches of terms.
+    class StochasticProblem : public Problem
+    {
+    public:
+        /// @brief Number of terms fᵢ of the objective.
+        virtual int num_terms() const = 0;
+
+        /// @brief Compute the gradient of a subset of the terms at x.
+        /// It is evaluated at points for which solution_changed was not called
+        /// (e.g., the SVRG snapshot), so it may only depend on x.
+        /// @param[in] x Degrees of freedom.
+        /// @param[in] indices Indices of the terms, in [0, num_terms()).
+        /// @param[out] grad Σᵢ ∇fᵢ(x) over the indices.
+        virtual void gradient_batch(const TVector &x, const Eigen::Ref<const Eigen::VectorXi> &indices, TVector &grad) = 0;
+
+        /// @brief Compute the gradient of all the terms.
+        void gradient(const TVector &x, TVector &grad) override
+        {
+            gradient_batch(x, Eigen::VectorXi::LinSpaced(num_terms(), 0, num_terms() - 1), grad);
+        }
+    };
+} // namespace polysolve::nonlinear
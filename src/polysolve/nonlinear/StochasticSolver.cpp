@@ -0,0 +1,228 @@
+#include "StochasticSolver.hpp"
+
+#include "Philox.hpp"
+#include "Solver.hpp"
+#include "descent_strategies/ADAM.hpp"
+#include "descent_strategies/GradientDescent.hpp"
+
+#include <polysolve/Utils.hpp>
+
+#include <spdlog/spdlog.h>
+
+namespace polysolve::nonlinear
+{
+    std::unique_ptr<StochasticSolver> StochasticSolver::create(
+        const json &solver_params_in,
+        const double characteristic_length,
+        spdlog::logger &logger,
+        const bool strict_validation)
+    {
+        json solver_params = Solver::validate_params(solver_params_in, logger, strict_validation);
+
+        if (!solver_params["solver"].is_string())
+            log_and_throw_error(logger, "StochasticSolver takes a single solver, not a list");
+
+        return std::make_unique<StochasticSolver>(solver_params, characteristic_length, logger);
+    }
+
+    std::vector<std::string> StochasticSolver::available_solvers()
+    {
+        return {"GradientDescent",
+                "StochasticGradientDescent",
+                "ADAM",
+                "StochasticADAM"};
+    }
+
+    StochasticSolver::StochasticSolver(const json &solver_params,
+                                       const double characteristic_length,
+                                       spdlog::logger &logger)
+        : m_logger(logger)
+    {
+        const std::string solver_name = solver_params["solver"];
+        if (solver_name == "GradientDescent" || solver_name == "gradient_descent")
+            m_strategy = std::make_shared<GradientDescent>(solver_params, false, characteristic_length, logger);
+        else if (solver_name == "StochasticGradientDescent" || solver_name == "stochastic_gradient_descent")
+            m_strategy = std::make_shared<GradientDescent>(solver_params, true, characteristic_length, logger);
+        else if (solver_name == "ADAM" || solver_name == "adam")
+            m_strategy = std::make_shared<ADAM>(solver_params, false, characteristic_length, logger);
+        else if (solver_name == "StochasticADAM" || solver_name == "stochastic_adam")
+            m_strategy = std::make_shared<ADAM>(solver_params, true, characteristic_length, logger);
+        else
+            log_and_throw_error(logger, "StochasticSolver only supports first-order solvers, instead got {}", solver_name);
+
+        const json &params = solver_params["stochastic"];
+        m_batch_size = params["batch_size"];
+        m_snapshot_frequency = params["snapshot_frequency"];
+        m_seed = params["seed"];
+
+        const std::string variance_reduction = params["variance_reduction"];
+        m_svrg = variance_reduction == "SVRG";
+
+        // ADAM directions are already scaled by its alpha
+        const bool is_adam = m_strategy->name().find("ADAM") != std::string::npos;
+        m_learning_rate = is_adam ? 1 : params["learning_rate"].get<double>();
+
+        if (m_batch_size <= 0)
+            log_and_throw_error(logger, "StochasticSolver batch_size must be > 0, instead got {}", m_batch_size);
+
+        m_current.reset();
+        m_stop.gradNorm = solver_params["grad_norm"];
+        m_stop.gradNorm *= characteristic_length;
+        m_stop.iterations = solver_params["max_iterations"];
+        allow_out_of_iterations = solver_params["allow_out_of_iterations"];
+    }
+
+    void StochasticSolver::shuffle(const uint64_t epoch)
+    {
+        // Fisher-Yates, the permutation only depends on the seed and the epoch
+        const Philox rng(m_seed);
+        for (int i = m_permutation.size() - 1; i > 0; --i)
+        {
+            const uint32_t r = rng(i, epoch)[0];
+            const int j = int((uint64_t(r) * uint64_t(i + 1)) >> 32);
+            std::swap(m_permutation[i], m_permutation[j]);
+        }
+    }
+
+    void StochasticSolver::minimize(StochasticProblem &problem, TVector &x)
+    {
+        const int num_terms = problem.num_terms();
+        if (num_terms <= 0)
+            log_and_throw_error(m_logger, "[StochasticSolver][{}] Problem has no terms (num_terms={})", m_strategy->name(), num_terms);
+
+        const int batch_size = std::min(m_batch_size, num_terms);
+        const int iterations_per_epoch = (num_terms + batch_size - 1) / batch_size;
+        const int snapshot_frequency = m_snapshot_frequency > 0 ? m_snapshot_frequency : iterations_per_epoch;
+
+        m_current.reset();
+        m_status = Status::Continue;
+        m_strategy->reset(x.size());
+        total_time = 0;
+        batch_gradient_time = 0;
+        full_gradient_time = 0;
+
+        m_permutation = Eigen::VectorXi::LinSpaced(num_terms, 0, num_terms - 1);
+
+        TVector grad(x.size()), batch_grad(x.size()), direction(x.size());
+        // SVRG snapshot and its full gradient μ
+        TVector snapshot_x, snapshot_grad, snapshot_batch_grad;
+
+        StopWatch stop_watch("stochastic solver", total_time, m_logger);
+        stop_watch.start();
+
+        problem.solution_changed(x);
+
+        int epoch = -1;
+        for (; m_current.iterations < m_stop.iterations; ++m_current.iterations)
+        {
+            const int it = m_current.iterations;
+            const int batch_index = it % iterations_per_epoch;
+
+            if (batch_index == 0)
+            {
+                ++epoch;
+                shuffle(epoch);
+
+                {
+                    POLYSOLVE_SCOPED_STOPWATCH("full gradient", full_gradient_time, m_logger);
+                    problem.gradient(x, grad);
+                }
+                m_current.gradNorm = grad.norm();
+                if (std::isnan(m_current.gradNorm))
+                {
+                    m_status = Status::NanEncountered;
+                    log_and_throw_error(m_logger, "[StochasticSolver][{}] Gradient is nan; stopping", m_strategy->name());
+                }
+
+                m_logger.debug("[StochasticSolver][{}] epoch {} ‖∇f‖={:g}", m_strategy->name(), epoch, m_current.gradNorm);
+
+                if (m_current.gradNorm < m_stop.gradNorm)
+                {
+                    m_status = Status::GradNormTolerance;
+                    break;
+                }
+            }
+
+            if (m_svrg && it % snapshot_frequency == 0)
+            {
+                snapshot_x = x;
+                if (batch_index == 0)
+                {
+                    snapshot_grad = grad;
+                }
+                else
+                {
+                    POLYSOLVE_SCOPED_STOPWATCH("full gradient", full_gradient_time, m_logger);
+                    problem.gradient(x, snapshot_grad);
+                }
+            }
+
+            // The last batch of an epoch can be smaller
+            const int start = batch_index * batch_size;
+            const auto batch = m_permutation.segment(start, std::min(batch_size, num_terms - start));
+            const double scale = double(num_terms) / batch.size();
+
+            {
+                POLYSOLVE_SCOPED_STOPWATCH("batch gradient", batch_gradient_time, m_logger);
+                problem.gradient_batch(x, batch, batch_grad);
+                if (m_svrg)
+                    problem.gradient_batch(snapshot_x, batch, snapshot_batch_grad);
+            }
+
+            // ĝ = N/|B| Σ_B ∇fᵢ(x) (- N/|B| Σ_B ∇fᵢ(x̃) + μ for SVRG)
+            if (m_svrg)
+                grad = scale * (batch_grad - snapshot_batch_grad) + snapshot_grad;
+            else
+                grad = scale * batch_grad;
+
+            if (!m_strategy->compute_update_direction(problem, x, grad, direction))
+            {
+                m_status = Status::UpdateDirectionFailed;
+                log_and_throw_error(m_logger, "[StochasticSolver][{}] {}; stopping", m_strategy->name(), status_message(m_status));
+            }
+
+            x += m_learning_rate * direction;
+            problem.solution_changed(x);
+
+            if (!problem.callback(m_current, x))
+            {
+                ++m_current.iterations;
+                break;
+            }
+            if (problem.stop(x))
+            {
+                ++m_current.iterations;
+                m_status = Status::ObjectiveCustomStop;
+                break;
+            }
+        }
+
+        // A callback stop keeps the Continue status, as in Solver::minimize
+        if (m_status == Status::Continue && m_current.iterations >= m_stop.iterations)
+            m_status = Status::IterationLimit;
+
+        stop_watch.stop();
+
+        if (!allow_out_of_iterations && m_status == Status::IterationLimit)
+            log_and_throw_error(m_logger, "[StochasticSolver][{}] Reached iteration limit (limit={})", m_strategy->name(), m_stop.iterations);
+
+        const bool succeeded = m_status == Status::GradNormTolerance;
+        m_logger.log(
+            succeeded ? spdlog::level::info : spdlog::level::err,
+            "[StochasticSolver][{}] Finished: {} took {:g}s ({} epochs, {})",
+            m_strategy->name(), status_message(m_status), stop_watch.getElapsedTimeInSec(),
+            epoch + 1, m_current.print_message());
+
+        const double per_iteration = m_current.iterations ? m_current.iterations : 1;
+
+        solver_info = json();
+        solver_info["status"] = m_status;
+        solver_info["energy"] = problem.value(x);
+        solver_info["iterations"] = m_current.iterations;
+        solver_info["epochs"] = epoch + 1;
+        solver_info["gradNorm"] = m_current.gradNorm;
+        solver_info["total_time"] = total_time;
+        solver_info["time_batch_gradient"] = batch_gradient_time / per_iteration;
+        solver_info["time_full_gradient"] = full_gradient_time;
+    }
+} // namespace polysolve::nonlinear
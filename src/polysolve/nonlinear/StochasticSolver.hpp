@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Criteria.hpp"
+#include "StochasticProblem.hpp"
+#include "descent_strategies/DescentStrategy.hpp"
+
+namespace spdlog
+{
+    class logger;
+}
+
+namespace polysolve::nonlinear
+{
+    /// @brief Mini-batch minimization of a StochasticProblem. Every iteration estimates the
+    /// gradient from a random batch of terms, optionally with SVRG variance reduction, and
+    /// takes a step along the direction of a first-order strategy (GradientDescent or ADAM).
+    /// The full gradient is only evaluated once per epoch, to check convergence.
+    class StochasticSolver
+    {
+    public:
+        using Scalar = typename Problem::Scalar;
+        using TVector = typename Problem::TVector;
+
+        /// @brief Static constructor, the parameters are validated with the nonlinear solver spec
+        static std::unique_ptr<StochasticSolver> create(
+            const json &solver_params,
+            const double characteristic_length,
+            spdlog::logger &logger,
+            const bool strict_validation = true);
+
+        /// @brief List available solvers
+        static std::vector<std::string> available_solvers();
+
+        StochasticSolver(const json &solver_params,
+                         const double characteristic_length,
+                         spdlog::logger &logger);
+
+        /// @brief Minimize the objective function
+        /// @param problem Objective function
+        /// @param x Initial guess
+        void minimize(StochasticProblem &problem, TVector &x);
+
+        Criteria &stop_criteria() { return m_stop; }
+        const Criteria &stop_criteria() const { return m_stop; }
+        const Criteria &current_criteria() const { return m_current; }
+        Status status() const { return m_status; }
+        const json &info() const { return solver_info; }
+
+        /// @brief If true the solver will not throw an error if the maximum number of iterations is reached
+        bool allow_out_of_iterations = false;
+
+    private:
+        /// @brief Random permutation of the terms visited during an epoch
+        void shuffle(const uint64_t epoch);
+
+        std::shared_ptr<DescentStrategy> m_strategy;
+        double m_learning_rate; ///< Step along the direction, 1 for ADAM which has its own
+        int m_batch_size;
+        bool m_svrg;
+        int m_snapshot_frequency; ///< Iterations between SVRG snapshots, 0 for once per epoch
+        uint64_t m_seed;
+
+        Criteria m_stop;
+        Criteria m_current;
+        Status m_status = Status::NotStarted;
+
+        spdlog::logger &m_logger;
+
+        json solver_info;
+
+        Eigen::VectorXi m_permutation;
+
+        // Timers
+        double total_time;
+        double batch_gradient_time;
+        double full_gradient_time;
+    };
+} // namespace polysolve::nonlinear
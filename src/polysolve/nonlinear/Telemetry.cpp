@@ -0,0 +1,107 @@
+#include "Telemetry.hpp"
+
+#include <polysolve/BinaryIO.hpp>
+
+#include <stdexcept>
+
+namespace polysolve::nonlinear
+{
+    json IterationRecord::to_json() const
+    {
+        json r;
+        r["iteration"] = iteration;
+        r["strategy"] = strategy;
+        r["energy"] = energy;
+        r["gradNorm"] = grad_norm;
+        r["xDelta"] = x_delta;
+        r["fDelta"] = f_delta;
+        r["step_size"] = step_size;
+        if (linear_iterations >= 0)
+            r["linear_iterations"] = linear_iterations;
+        if (linear_residual >= 0)
+            r["linear_residual"] = linear_residual;
+        r["time_obj_fun"] = time_obj_fun;
+        r["time_direction"] = time_direction;
+        r["time_line_search"] = time_line_search;
+        return r;
+    }
+
+    Telemetry::Telemetry(const size_t capacity)
+    {
+        set_capacity(capacity);
+    }
+
+    void Telemetry::set_capacity(const size_t capacity)
+    {
+        records.assign(capacity, IterationRecord());
+        clear();
+    }
+
+    void Telemetry::clear()
+    {
+        first = 0;
+        count = 0;
+        pushed = 0;
+    }
+
+    void Telemetry::push(const IterationRecord &record)
+    {
+        ++pushed;
+
+        if (sink)
+        {
+            if (sink_json_lines)
+                *sink << record.to_json().dump() << '\n';
+            else
+                write_value(*sink, record);
+        }
+
+        if (records.empty())
+            return;
+
+        if (count < records.size())
+        {
+            records[(first + count) % records.size()] = record;
+            ++count;
+        }
+        else
+        {
+            // Overwrite the oldest record
+            records[first] = record;
+            first = (first + 1) % records.size();
+        }
+    }
+
+    json Telemetry::to_json() const
+    {
+        json res = json::array();
+        for (size_t i = 0; i < count; ++i)
+            res.push_back((*this)[i].to_json());
+        return res;
+    }
+
+    void Telemetry::open_sink(const std::string &path)
+    {
+        const size_t dot = path.find_last_of('.');
+        sink_json_lines = dot != std::string::npos && path.substr(dot) == ".jsonl";
+
+        sink = std::make_unique<std::ofstream>(path, sink_json_lines ? std::ios::out : std::ios::binary);
+        if (!sink->is_open())
+        {
+            sink.reset();
+            throw std::runtime_error("Unable to open " + path + " for writing");
+        }
+
+        if (!sink_json_lines)
+        {
+            constexpr char magic[8] = {'P', 'S', 'T', 'E', 'L', 'E', 'M', '\0'};
+            sink->write(magic, sizeof(magic));
+            write_value(*sink, uint32_t(sizeof(IterationRecord)));
+        }
+    }
+
+    void Telemetry::close_sink()
+    {
+        sink.reset();
+    }
+} // namespace polysolve::nonlinear
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <polysolve/Types.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace polysolve::nonlinear
+{
+    /// @brief Typed record of one solver iteration. Trivially copyable, so that it is
+    /// stored without allocations and streamed as raw bytes.
+    struct IterationRecord
+    {
+        uint64_t iteration = 0;
+        int32_t strategy = -1;          ///< Index of the descent strategy that computed the step
+        int32_t linear_iterations = -1; ///< Iterations of the direction solve, -1 if unknown
+        double energy = 0;
+        double grad_norm = 0;
+        double x_delta = 0;          ///< ‖Δx‖ of the direction
+        double f_delta = 0;          ///< |f(xₖ) - f(xₖ₋₁)|
+        double step_size = 0;        ///< Scale of the direction accepted by the line search
+        double linear_residual = -1; ///< Residual of the direction solve, -1 if unknown
+
+        // Seconds spent since the previous record, including failed attempts
+        double time_obj_fun = 0; ///< Energy and gradient, evaluated together
+        double time_direction = 0;
+        double time_line_search = 0;
+
+        json to_json() const;
+    };
+
+    /// @brief Fixed-size ring buffer of the last iteration records, with an optional
+    /// stream of every record to a file. Pushing a record never allocates.
+    class Telemetry
+    {
+    public:
+        /// @param capacity Number of records kept in memory, 0 to only stream them.
+        explicit Telemetry(const size_t capacity = 0);
+
+        /// @brief Preallocate the buffer, dropping the stored records.
+        void set_capacity(const size_t capacity);
+        size_t capacity() const { return records.size(); }
+
+        /// @brief Drop the stored records, the sink is kept.
+        void clear();
+
+        void push(const IterationRecord &record);
+
+        /// @brief Number of records in the buffer.
+        size_t size() const { return count; }
+        /// @brief Number of records pushed since the last clear, including the overwritten ones.
+        uint64_t total() const { return pushed; }
+
+        /// @brief i-th stored record, oldest first.
+        const IterationRecord &operator[](const size_t i) const { return records[(first + i) % records.size()]; }
+        const IterationRecord &back() const { return (*this)[count - 1]; }
+
+        /// @brief The stored records, oldest first.
+        json to_json() const;
+
+        /// @brief Stream every pushed record to a file, as JSON lines if the extension is
+        /// .jsonl, otherwise as raw IterationRecords after the header "PSTELEM\0" and the record size.
+        void open_sink(const std::string &path);
+        void close_sink();
+
+    private:
+        std::vector<IterationRecord> records;
+        size_t first = 0;
+        size_t count = 0;
+        uint64_t pushed = 0;
+
+        std::unique_ptr<std::ofstream> sink;
+        bool sink_json_lines = false;
+    };
+} // namespace polysolve::nonlinear
@@ -1,8 +1,10 @@
 // ADAM from "ADAM: A METHOD FOR STOCHASTIC OPTIMIZATION"
 
 #include "ADAM.hpp"
+#include "VectorKernels.hpp"
 
 #include <polysolve/Utils.hpp>
+#include <polysolve/BinaryIO.hpp>
 
 namespace polysolve::nonlinear
 {
@@ -19,15 +21,43 @@ namespace polysolve::nonlinear
         beta_2_ = extract_param(param_name, "beta_2", solver_params);
         epsilon_ = extract_param(param_name, "epsilon", solver_params);
         if (is_stochastic)
+        {
             erase_component_probability_ = extract_param("StochasticADAM", "erase_component_probability", solver_params);
+            seed_ = static_cast<uint64_t>(extract_param("StochasticADAM", "seed", solver_params));
+        }
     }
 
     void ADAM::reset(const int ndof)
     {
         Superclass::reset(ndof);
-        m_prev_ = Eigen::VectorXd::Zero(ndof);
-        v_prev_ = Eigen::VectorXd::Zero(ndof);
+        first_moment_.setZero(ndof);
+        second_moment_.setZero(ndof);
         t_ = 0;
+        beta_1_t_ = 1;
+        beta_2_t_ = 1;
+    }
+
+    void ADAM::warm_start(const int ndof)
+    {
+        // Keep the moments and their bias corrections
+    }
+
+    void ADAM::save_state(std::ostream &out) const
+    {
+        write_dense(out, first_moment_);
+        write_dense(out, second_moment_);
+        write_value(out, t_);
+        write_value(out, beta_1_t_);
+        write_value(out, beta_2_t_);
+    }
+
+    void ADAM::load_state(std::istream &in)
+    {
+        read_dense(in, first_moment_);
+        read_dense(in, second_moment_);
+        read_value(in, t_);
+        read_value(in, beta_1_t_);
+        read_value(in, beta_2_t_);
     }
 
     bool ADAM::compute_update_direction(
@@ -36,33 +66,44 @@ namespace polysolve::nonlinear
         const TVector &grad,
         TVector &direction)
     {
-        if (m_prev_.size() == 0)
-            m_prev_ = Eigen::VectorXd::Zero(x.size());
-        if (v_prev_.size() == 0)
-            v_prev_ = Eigen::VectorXd::Zero(x.size());
-
-        TVector grad_modified = grad;
+        if (first_moment_.size() != x.size())
+            first_moment_.setZero(x.size());
+        if (second_moment_.size() != x.size())
+            second_moment_.setZero(x.size());
 
-        if (is_stochastic_)
-        {
-            Eigen::VectorXd mask = (Eigen::VectorXd::Random(direction.size()).array() + 1.) / 2.;
-            for (int i = 0; i < direction.size(); ++i)
-                grad_modified(i) *= (mask(i) < erase_component_probability_) ? 0. : 1.;
-        }
+        ++t_;
+        beta_1_t_ *= beta_1_;
+        beta_2_t_ *= beta_2_;
+        const double m_scale = 1 / (1 - beta_1_t_);
+        const double v_scale = 1 / (1 - beta_2_t_);
 
-        TVector m = (beta_1_ * m_prev_) + ((1 - beta_1_) * grad_modified);
-        TVector v = beta_2_ * v_prev_;
-        for (int i = 0; i < v.size(); ++i)
-            v(i) += (1 - beta_2_) * grad_modified(i) * grad_modified(i);
+        const Philox rng(seed_);
+        const uint64_t threshold = Philox::threshold(erase_component_probability_);
 
-        m = m.array() / (1 - pow(beta_1_, t_));
-        v = v.array() / (1 - pow(beta_2_, t_));
+        direction.resize(grad.size());
 
-        direction = -alpha_ * m;
-        for (int i = 0; i < v.size(); ++i)
-            direction(i) /= sqrt(v(i) + epsilon_);
+        // m, v and the direction are updated in a single pass over the vectors
+        for_each_block(grad.size(), [&](const Eigen::Index, const Eigen::Index start, const Eigen::Index size) {
+            const auto update = [&](const auto &g) {
+                auto m = first_moment_.segment(start, size).array();
+                auto v = second_moment_.segment(start, size).array();
+                m = beta_1_ * m + (1 - beta_1_) * g;
+                v = beta_2_ * v + (1 - beta_2_) * g.square();
+                direction.segment(start, size).array() = (-alpha_ * m_scale) * m / (v_scale * v + epsilon_).sqrt();
+            };
 
-        ++t_;
+            const auto g = grad.segment(start, size).array();
+            if (is_stochastic_)
+            {
+                // The direction holds the mask until it is overwritten
+                random_keep_mask(rng, t_, threshold, start, direction.segment(start, size));
+                update(g * direction.segment(start, size).array());
+            }
+            else
+            {
+                update(g);
+            }
+        });
 
         return true;
     }
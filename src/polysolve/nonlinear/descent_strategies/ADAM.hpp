@@ -20,6 +20,9 @@ namespace polysolve::nonlinear
         std::string name() const override { return is_stochastic_ ? "StochasticADAM" : "ADAM"; }
 
         void reset(const int ndof) override;
+        void warm_start(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
 
         virtual bool compute_update_direction(
             Problem &objFunc,
@@ -30,16 +33,19 @@ namespace polysolve::nonlinear
         bool is_direction_descent() override { return false; }
 
     private:
-        TVector m_prev_;
-        TVector v_prev_;
+        TVector first_moment_;  ///< First moment estimate, updated in place
+        TVector second_moment_; ///< Second moment estimate, updated in place
 
         double beta_1_, beta_2_;
         double alpha_;
 
         int t_ = 0;
+        double beta_1_t_ = 1; ///< β₁ᵗ of the bias correction
+        double beta_2_t_ = 1; ///< β₂ᵗ of the bias correction
         double epsilon_;
 
         bool is_stochastic_;
         double erase_component_probability_ = 0;
+        uint64_t seed_ = 0;
     };
 } // namespace polysolve::nonlinear
@@ -2,6 +2,8 @@
 
 #include "BFGS.hpp"
 
+#include <polysolve/BinaryIO.hpp>
+
 namespace polysolve::nonlinear
 {
 
@@ -11,6 +13,16 @@ namespace polysolve::nonlinear
                spdlog::logger &logger)
         : Superclass(solver_params, characteristic_length, logger)
     {
+        const json &params = solver_params.contains("BFGS") ? solver_params["BFGS"] : solver_params;
+        const std::string update = params.value("update", "Hessian");
+        if (update != "InverseHessian" && update != "Hessian")
+            log_and_throw_error(logger, "BFGS update must be InverseHessian or Hessian, instead got {}", update);
+        m_inverse_update = update == "InverseHessian";
+
+        // The inverse update does not solve any system
+        if (m_inverse_update)
+            return;
+
         linear_solver = polysolve::linear::Solver::create(linear_solver_params, logger);
         if (!linear_solver->is_dense())
             log_and_throw_error(logger, "BFGS linear solver must be dense, instead got {}", linear_solver->name());
@@ -22,12 +34,48 @@ namespace polysolve::nonlinear
         reset_history(ndof);
     }
 
+    void BFGS::warm_start(const int ndof)
+    {
+        // Keep the Hessian approximation, the next correction is taken within the new problem
+        m_prev_x.resize(0);
+    }
+
+    void BFGS::save_state(std::ostream &out) const
+    {
+        write_value(out, m_inverse_update);
+        write_dense(out, hess);
+        write_value(out, m_initial_hess);
+        write_dense(out, m_prev_x);
+        write_dense(out, m_prev_grad);
+    }
+
+    void BFGS::load_state(std::istream &in)
+    {
+        bool inverse_update;
+        read_value(in, inverse_update);
+        if (inverse_update != m_inverse_update)
+        {
+            // The matrix was saved with another update, hess would hold its inverse
+            in.setstate(std::ios::failbit);
+            return;
+        }
+        read_dense(in, hess);
+        read_value(in, m_initial_hess);
+        read_dense(in, m_prev_x);
+        read_dense(in, m_prev_grad);
+    }
+
     void BFGS::reset_history(const int ndof)
     {
         m_prev_x.resize(0);
         m_prev_grad.resize(ndof);
 
         hess.setIdentity(ndof, ndof);
+        m_initial_hess = true;
+
+        m_s.resize(ndof);
+        m_y.resize(ndof);
+        m_Hy.resize(ndof);
     }
 
     bool BFGS::compute_update_direction(
@@ -40,28 +88,51 @@ namespace polysolve::nonlinear
         {
             direction = -grad;
         }
+        else if (m_inverse_update)
+        {
+            m_s = x - m_prev_x;
+            m_y = grad - m_prev_grad;
+            update_inverse_hessian();
+
+            // d = -H g
+            direction.setZero(grad.size());
+            direction.noalias() -= hess.selfadjointView<Eigen::Upper>() * grad;
+        }
         else
         {
+            // B is stored in the upper triangle of hess, the lower triangle is
+            // scratch space where the linear solver can factorize in place.
+            const int n = hess.rows();
+            for (int j = 0; j < n - 1; ++j)
+                hess.col(j).tail(n - j - 1) = hess.row(j).tail(n - j - 1).transpose();
+
+            const bool inplace = linear_solver->factorize_dense_preserves_upper();
+            if (inplace)
+                diagonal = hess.diagonal();
+
             try
             {
                 linear_solver->analyze_pattern_dense(hess, hess.rows());
-                linear_solver->factorize_dense(hess);
+                if (inplace)
+                    linear_solver->factorize_dense_inplace(hess);
+                else
+                    linear_solver->factorize_dense(hess);
                 linear_solver->solve(-grad, direction);
             }
             catch (const std::runtime_error &err)
             {
+                if (inplace)
+                    hess.diagonal() = diagonal;
                 m_logger.debug("Unable to factorize Hessian: \"{}\";", err.what());
                 return false;
             }
 
-            TVector y = grad - m_prev_grad;
-            TVector s = x - m_prev_x;
+            if (inplace)
+                hess.diagonal() = diagonal;
 
-            double y_s = y.dot(s);
-            TVector Bs = hess * s;
-            double sBs = s.transpose() * Bs;
-
-            hess += (y * y.transpose()) / y_s - (Bs * Bs.transpose()) / sBs;
+            m_s = x - m_prev_x;
+            m_y = grad - m_prev_grad;
+            update_hessian();
         }
 
         m_prev_x = x;
@@ -69,4 +140,41 @@ namespace polysolve::nonlinear
 
         return true;
     }
+
+    void BFGS::update_inverse_hessian()
+    {
+        const double y_s = m_y.dot(m_s);
+        if (!(y_s > 0))
+        {
+            m_logger.debug("[{}] skipping update with non-positive curvature yᵀs={}", name(), y_s);
+            return;
+        }
+
+        // Scale the initial identity before the first update (Nocedal and Wright, eq. 6.20)
+        if (m_initial_hess)
+        {
+            hess.diagonal().setConstant(y_s / m_y.squaredNorm());
+            m_initial_hess = false;
+        }
+
+        // H⁺ = (I - ρsyᵀ) H (I - ρysᵀ) + ρssᵀ
+        //    = H - ρ(s(Hy)ᵀ + (Hy)sᵀ) + (ρ + ρ² yᵀHy) ssᵀ
+        const double rho = 1 / y_s;
+        m_Hy.noalias() = hess.selfadjointView<Eigen::Upper>() * m_y;
+        const double yHy = m_y.dot(m_Hy);
+
+        hess.selfadjointView<Eigen::Upper>().rankUpdate(m_s, m_Hy, -rho);
+        hess.selfadjointView<Eigen::Upper>().rankUpdate(m_s, rho + rho * rho * yHy);
+    }
+
+    void BFGS::update_hessian()
+    {
+        // B⁺ = B + yyᵀ / yᵀs - (Bs)(Bs)ᵀ / sᵀBs
+        const double y_s = m_y.dot(m_s);
+        m_Hy.noalias() = hess.selfadjointView<Eigen::Upper>() * m_s;
+        const double sBs = m_s.dot(m_Hy);
+
+        hess.selfadjointView<Eigen::Upper>().rankUpdate(m_y, 1 / y_s);
+        hess.selfadjointView<Eigen::Upper>().rankUpdate(m_Hy, -1 / sBs);
+    }
 } // namespace polysolve::nonlinear
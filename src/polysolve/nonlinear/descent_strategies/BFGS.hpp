@@ -7,8 +7,6 @@
 
 #include <polysolve/linear/Solver.hpp>
 
-#include <LBFGSpp/BFGSMat.h>
-
 namespace polysolve::nonlinear
 {
     class BFGS : public DescentStrategy
@@ -24,6 +22,9 @@ namespace polysolve::nonlinear
         std::string name() const override { return "BFGS"; }
 
         void reset(const int ndof) override;
+        void warm_start(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
 
         virtual bool compute_update_direction(
             Problem &objFunc,
@@ -35,10 +36,24 @@ namespace polysolve::nonlinear
         TVector m_prev_x;    // Previous x
         TVector m_prev_grad; // Previous gradient
 
-        Eigen::MatrixXd hess;
+        /// Update the inverse Hessian approximation H instead of B, the direction
+        /// is then a product with H instead of a dense factorization
+        bool m_inverse_update;
+
+        Eigen::MatrixXd hess;     // Hessian (or inverse) approximation, only the upper triangle is valid
+        Eigen::VectorXd diagonal; // Diagonal of hess while it holds the factors
+        bool m_initial_hess;      // hess is still the identity it was reset to
+
+        // Work vectors of the update
+        TVector m_s;  // x - x_prev
+        TVector m_y;  // g - g_prev
+        TVector m_Hy; // Hy, or Bs for the Hessian update
 
         void reset_history(const int ndof);
 
+        void update_inverse_hessian();
+        void update_hessian();
+
         std::unique_ptr<polysolve::linear::Solver> linear_solver; ///< Linear solver used to solve the linear system
     };
 } // namespace polysolve::nonlinear
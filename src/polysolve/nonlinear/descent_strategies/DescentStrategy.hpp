@@ -1,8 +1,12 @@
 #pragma once
 
+#include <polysolve/Cancellation.hpp>
 #include <polysolve/Utils.hpp>
 
 #include <polysolve/nonlinear/Problem.hpp>
+#include <polysolve/nonlinear/Telemetry.hpp>
+
+#include <iosfwd>
 
 namespace polysolve::nonlinear
 {
@@ -29,15 +33,37 @@ namespace polysolve::nonlinear
         virtual void reset(const int ndof) {}
         virtual void reset_times() {}
 
+        /// @brief Reset when the solver returns to this strategy after a fallback, within the same
+        /// minimization. Resets by default.
+        virtual void restart(const int ndof) { reset(ndof); }
+
+        /// @brief Prepare the next minimization of a similar problem with as many dofs,
+        /// keeping the state that remains useful (e.g., a quasi-Newton history). Resets by default.
+        virtual void warm_start(const int ndof) { reset(ndof); }
+
+        /// @brief Write the state accumulated over the iterations (e.g., a quasi-Newton history) to a checkpoint
+        virtual void save_state(std::ostream &out) const {}
+        /// @brief Restore the state written by save_state, called right after reset(ndof)
+        virtual void load_state(std::istream &in) {}
+
         /// @brief Update solver info after finding descent direction
         /// @param solver_info JSON of solver parameters
         /// @param per_iteration Number of iterations (used to normalize timings)
         virtual void update_solver_info(json &solver_info, const double per_iteration) {}
+        /// @brief Add the statistics of the last direction (e.g., its linear solve) to the iteration telemetry
+        virtual void update_iteration_record(IterationRecord &record) const {}
         virtual void log_times() const {}
 
         virtual bool is_direction_descent() { return true; }
+
+        /// @brief If false, the strategy already accepted the full step and the line search is skipped
+        virtual bool uses_line_search() const { return true; }
         virtual bool handle_error() { return false; }
 
+        /// @brief Token checked by the inner loops (e.g., CG iterations, linear solves); once
+        /// it is cancelled, compute_update_direction returns early and its result is discarded
+        virtual void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) { m_cancellation = token; }
+
         /// @brief Compute descent direction along which to do line search
         /// @param objFunc Problem to be minimized
         /// @param x Current input (n x 1)
@@ -51,6 +77,9 @@ namespace polysolve::nonlinear
             TVector &direction) = 0;
 
     protected:
+        bool is_cancelled() const { return m_cancellation && m_cancellation->is_cancelled(); }
+
         spdlog::logger &m_logger;
+        std::shared_ptr<const CancellationToken> m_cancellation;
     };
 } // namespace polysolve::nonlinear
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "GradientDescent.hpp"
+#include "VectorKernels.hpp"
 
 #include <polysolve/Utils.hpp>
+#include <polysolve/BinaryIO.hpp>
 
 namespace polysolve::nonlinear
 {
@@ -12,7 +14,26 @@ namespace polysolve::nonlinear
         : Superclass(solver_params_, characteristic_length, logger), is_stochastic_(is_stochastic)
     {
         if (is_stochastic_)
+        {
             erase_component_probability_ = extract_param("StochasticGradientDescent", "erase_component_probability", solver_params_);
+            seed_ = static_cast<uint64_t>(extract_param("StochasticGradientDescent", "seed", solver_params_));
+        }
+    }
+
+    void GradientDescent::reset(const int ndof)
+    {
+        Superclass::reset(ndof);
+        iteration_ = 0;
+    }
+
+    void GradientDescent::save_state(std::ostream &out) const
+    {
+        write_value(out, iteration_);
+    }
+
+    void GradientDescent::load_state(std::istream &in)
+    {
+        read_value(in, iteration_);
     }
 
     bool GradientDescent::compute_update_direction(
@@ -21,15 +42,23 @@ namespace polysolve::nonlinear
         const TVector &grad,
         TVector &direction)
     {
-        direction = -grad;
-
-        if (is_stochastic_)
+        if (!is_stochastic_)
         {
-            Eigen::VectorXd mask = (Eigen::VectorXd::Random(direction.size()).array() + 1.) / 2.;
-            for (int i = 0; i < direction.size(); ++i)
-                direction(i) *= (mask(i) < erase_component_probability_) ? 0. : 1.;
+            direction = -grad;
+            return true;
         }
 
+        const Philox rng(seed_);
+        const uint64_t threshold = Philox::threshold(erase_component_probability_);
+        ++iteration_;
+
+        direction.resize(grad.size());
+        for_each_block(grad.size(), [&](const Eigen::Index, const Eigen::Index start, const Eigen::Index size) {
+            auto d = direction.segment(start, size);
+            random_keep_mask(rng, iteration_, threshold, start, d);
+            d.array() *= -grad.segment(start, size).array();
+        });
+
         return true;
     }
 
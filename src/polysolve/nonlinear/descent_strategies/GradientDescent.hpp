@@ -19,6 +19,10 @@ namespace polysolve::nonlinear
 
         std::string name() const override { return is_stochastic_ ? "StochasticGradientDescent" : "GradientDescent"; }
 
+        void reset(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
+
         bool compute_update_direction(
             Problem &objFunc,
             const TVector &x,
@@ -28,5 +32,7 @@ namespace polysolve::nonlinear
     private:
         bool is_stochastic_ = false;
         double erase_component_probability_ = 0;
+        uint64_t seed_ = 0;
+        uint64_t iteration_ = 0; ///< Stream of the random mask
     };
 } // namespace polysolve::nonlinear
@@ -1,11 +1,49 @@
-// L-BFGS solver (Using the LBFGSpp under MIT License).
+// L-BFGS solver, compact representation of Byrd, Nocedal and Schnabel (1994).
 
 #include "LBFGS.hpp"
+#include "VectorKernels.hpp"
 
+#include <polysolve/BinaryIO.hpp>
 #include <polysolve/Utils.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace polysolve::nonlinear
 {
+    namespace
+    {
+        /// out = W[:, :cols]ᵀ v, accumulated in double
+        template <typename History>
+        void history_transpose_product(
+            const History &W, const Eigen::Index cols, const Eigen::VectorXd &v,
+            Eigen::MatrixXd &partial, Eigen::VectorXd &out)
+        {
+            for_each_block(W.rows(), [&](const Eigen::Index b, const Eigen::Index start, const Eigen::Index size) {
+                const auto v_block = v.segment(start, size);
+                for (Eigen::Index j = 0; j < cols; ++j)
+                    partial(j, b) = W.col(j).segment(start, size).template cast<double>().dot(v_block);
+            });
+            // Summed in a fixed order, the result does not depend on the number of threads
+            out.head(cols) = partial.topRows(cols).rowwise().sum();
+        }
+
+        /// out = alpha v + W[:, :cols] c
+        template <typename History>
+        void history_product(
+            const History &W, const Eigen::Index cols, const Eigen::VectorXd &c,
+            const double alpha, const Eigen::VectorXd &v, Eigen::VectorXd &out)
+        {
+            for_each_block(W.rows(), [&](const Eigen::Index, const Eigen::Index start, const Eigen::Index size) {
+                auto out_block = out.segment(start, size);
+                out_block = alpha * v.segment(start, size);
+                for (Eigen::Index j = 0; j < cols; ++j)
+                    if (c[j] != 0)
+                        out_block += c[j] * W.col(j).segment(start, size).template cast<double>();
+            });
+        }
+    } // namespace
+
     LBFGS::LBFGS(const json &solver_params,
                  const double characteristic_length,
                  spdlog::logger &logger)
@@ -16,16 +54,95 @@ namespace polysolve::nonlinear
         m_history_size = extract_param("L-BFGS", "history_size", solver_params);
         if (m_history_size <= 0)
             log_and_throw_error(logger, "L-BFGS history_size must be >=1, instead got {}", m_history_size);
+
+        const json &params = solver_params.contains("L-BFGS") ? solver_params["L-BFGS"] : solver_params;
+        const std::string precision = params.value("history_precision", "double");
+        if (precision != "double" && precision != "float")
+            log_and_throw_error(logger, "L-BFGS history_precision must be double or float, instead got {}", precision);
+        m_float_history = precision == "float";
     }
 
     void LBFGS::reset(const int ndof)
     {
         Superclass::reset(ndof);
 
-        m_bfgs.reset(ndof, m_history_size);
+        const int slots = m_history_size + 1;
+        if (m_float_history)
+        {
+            m_history.resize(0, 0);
+            m_history_float.resize(ndof, 2 * slots);
+        }
+        else
+        {
+            m_history.resize(ndof, 2 * slots);
+            m_history_float.resize(0, 0);
+        }
+
+        m_first_slot = 0;
+        m_num_corrections = 0;
+        m_gamma = 1;
+
+        m_sy.resize(slots, slots);
+        m_yy.resize(slots, slots);
+
+        m_partial_products.resize(2 * slots, num_blocks(ndof));
+        m_products.resize(2 * slots);
+        m_coefficients.resize(2 * slots);
+        m_R.resize(m_history_size, m_history_size);
+        m_a.resize(m_history_size);
+        m_b.resize(m_history_size);
+
+        m_prev_x.resize(0);
+    }
+
+    void LBFGS::warm_start(const int ndof)
+    {
+        // Keep the corrections, the next one is taken within the new problem
         m_prev_x.resize(0);
     }
 
+    void LBFGS::save_state(std::ostream &out) const
+    {
+        write_value(out, m_float_history);
+        if (m_float_history)
+            write_dense(out, m_history_float);
+        else
+            write_dense(out, m_history);
+        write_value(out, m_first_slot);
+        write_value(out, m_num_corrections);
+        write_value(out, m_gamma);
+        write_dense(out, m_sy);
+        write_dense(out, m_yy);
+        write_dense(out, m_prev_x);
+        write_dense(out, m_prev_grad);
+    }
+
+    void LBFGS::load_state(std::istream &in)
+    {
+        bool float_history;
+        read_value(in, float_history);
+        if (float_history != m_float_history)
+        {
+            // The history was saved with another history_precision
+            in.setstate(std::ios::failbit);
+            return;
+        }
+        if (m_float_history)
+            read_dense(in, m_history_float);
+        else
+            read_dense(in, m_history);
+        read_value(in, m_first_slot);
+        read_value(in, m_num_corrections);
+        read_value(in, m_gamma);
+        read_dense(in, m_sy);
+        read_dense(in, m_yy);
+        read_dense(in, m_prev_x);
+        read_dense(in, m_prev_grad);
+
+        if (m_sy.rows() != m_history_size + 1 || m_num_corrections > m_history_size)
+            in.setstate(std::ios::failbit);
+    }
+
     bool LBFGS::compute_update_direction(
         Problem &objFunc,
         const TVector &x,
@@ -39,15 +156,20 @@ namespace polysolve::nonlinear
         }
         else
         {
-            // Update s and y
-            // s_{i+1} = x_{i+1} - x_i
-            // y_{i+1} = g_{i+1} - g_i
             assert(m_prev_x.size() == x.size());
             assert(m_prev_grad.size() == grad.size());
-            m_bfgs.add_correction(x - m_prev_x, grad - m_prev_grad);
-
-            // Recursive formula to compute d = -H * g
-            m_bfgs.apply_Hv(grad, -Scalar(1), direction);
+            if (m_float_history)
+            {
+                if (!add_correction(m_history_float, x, grad))
+                    m_logger.debug("[{}] skipping correction with non-positive curvature", name());
+                apply_inverse_hessian(m_history_float, grad, direction);
+            }
+            else
+            {
+                if (!add_correction(m_history, x, grad))
+                    m_logger.debug("[{}] skipping correction with non-positive curvature", name());
+                apply_inverse_hessian(m_history, grad, direction);
+            }
         }
 
         m_prev_x = x;
@@ -55,4 +177,100 @@ namespace polysolve::nonlinear
 
         return true;
     }
+
+    template <typename History>
+    bool LBFGS::add_correction(History &history, const TVector &x, const TVector &grad)
+    {
+        using HistoryScalar = typename History::Scalar;
+
+        const int slots = m_history_size + 1;
+        const int slot = (m_first_slot + m_num_corrections) % slots;
+
+        // s = x - x_prev, y = g - g_prev, the previous gradient is replaced by the
+        // stored y since it is overwritten after this iteration anyway
+        Eigen::VectorXd &y = m_prev_grad;
+        for_each_block(x.size(), [&](const Eigen::Index, const Eigen::Index start, const Eigen::Index size) {
+            history.col(2 * slot).segment(start, size) =
+                (x.segment(start, size) - m_prev_x.segment(start, size)).template cast<HistoryScalar>();
+            history.col(2 * slot + 1).segment(start, size) =
+                (grad.segment(start, size) - y.segment(start, size)).template cast<HistoryScalar>();
+            y.segment(start, size) = history.col(2 * slot + 1).segment(start, size).template cast<double>();
+        });
+
+        // The used slots are contiguous, all inner products with y come from one pass
+        const int cols = 2 * std::min(m_num_corrections + 1, slots);
+        history_transpose_product(history, cols, y, m_partial_products, m_products);
+
+        const double sy = m_products[2 * slot];
+        const double yy = m_products[2 * slot + 1];
+        if (!(sy > std::numeric_limits<double>::epsilon() * yy))
+            return false;
+
+        for (int k = 0; k <= m_num_corrections && k < slots; ++k)
+        {
+            const int i = (m_first_slot + k) % slots;
+            m_sy(i, slot) = m_products[2 * i];
+            m_yy(i, slot) = m_yy(slot, i) = m_products[2 * i + 1];
+        }
+        m_gamma = sy / yy;
+
+        if (m_num_corrections == m_history_size)
+            m_first_slot = (m_first_slot + 1) % slots;
+        else
+            ++m_num_corrections;
+
+        return true;
+    }
+
+    template <typename History>
+    void LBFGS::apply_inverse_hessian(const History &history, const TVector &grad, TVector &direction)
+    {
+        const int k = m_num_corrections;
+        if (k == 0)
+        {
+            direction = -grad;
+            return;
+        }
+
+        const int slots = m_history_size + 1;
+        const auto slot = [&](const int a) { return (m_first_slot + a) % slots; };
+        // Before the history is full the corrections are in the first slots
+        const int cols = k == m_history_size ? 2 * slots : 2 * k;
+
+        // p = Sᵀg, q = Yᵀg
+        history_transpose_product(history, cols, grad, m_partial_products, m_products);
+
+        auto R = m_R.topLeftCorner(k, k);
+        auto a = m_a.head(k);
+        auto b = m_b.head(k);
+        for (int j = 0; j < k; ++j)
+        {
+            for (int i = 0; i <= j; ++i)
+                R(i, j) = m_sy(slot(i), slot(j));
+            a[j] = m_products[2 * slot(j)];
+        }
+
+        // a = R⁻¹ p
+        R.triangularView<Eigen::Upper>().solveInPlace(a);
+
+        // b = R⁻ᵀ ((D + γ YᵀY) a - γ q)
+        for (int i = 0; i < k; ++i)
+        {
+            double yya = 0;
+            for (int j = 0; j < k; ++j)
+                yya += m_yy(slot(i), slot(j)) * a[j];
+            b[i] = R(i, i) * a[i] + m_gamma * (yya - m_products[2 * slot(i) + 1]);
+        }
+        R.triangularView<Eigen::Upper>().transpose().solveInPlace(b);
+
+        // d = -(γ g + S b - γ Y a)
+        m_coefficients.setZero();
+        for (int i = 0; i < k; ++i)
+        {
+            m_coefficients[2 * slot(i)] = -b[i];
+            m_coefficients[2 * slot(i) + 1] = m_gamma * a[i];
+        }
+        direction.resize(grad.size());
+        history_product(history, cols, m_coefficients, -m_gamma, grad, direction);
+    }
 } // namespace polysolve::nonlinear
@@ -1,12 +1,10 @@
-// L-BFGS solver (Using the LBFGSpp under MIT License).
+// L-BFGS solver, compact representation of Byrd, Nocedal and Schnabel (1994).
 
 #pragma once
 
 #include "DescentStrategy.hpp"
 #include <polysolve/Utils.hpp>
 
-#include <LBFGSpp/BFGSMat.h>
-
 namespace polysolve::nonlinear
 {
     class LBFGS : public DescentStrategy
@@ -22,6 +20,9 @@ namespace polysolve::nonlinear
 
     public:
         void reset(const int ndof) override;
+        void warm_start(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
 
         bool compute_update_direction(
             Problem &objFunc,
@@ -30,7 +31,13 @@ namespace polysolve::nonlinear
             TVector &direction) override;
 
     private:
-        LBFGSpp::BFGSMat<Scalar> m_bfgs; // Approximation to the Hessian matrix
+        /// Stores the new correction in the free slot, returns false if it is rejected
+        template <typename History>
+        bool add_correction(History &history, const TVector &x, const TVector &grad);
+
+        /// d = -H g with H = γI + [S γY] M [S γY]ᵀ
+        template <typename History>
+        void apply_inverse_hessian(const History &history, const TVector &grad, TVector &direction);
 
         /// The number of corrections to approximate the inverse Hessian matrix.
         /// The L-BFGS routine stores the computation results of previous \ref m
@@ -40,6 +47,28 @@ namespace polysolve::nonlinear
         /// not recommended. Large values will result in excessive computing time.
         int m_history_size;
 
+        /// Store the corrections in single precision
+        bool m_float_history;
+
+        // Corrections sᵢ and yᵢ interleaved in columns 2i and 2i+1, one slot more
+        // than the history size so that a new correction never overwrites an accepted one
+        Eigen::MatrixXd m_history;
+        Eigen::MatrixXf m_history_float;
+
+        int m_first_slot;      // Slot of the oldest correction
+        int m_num_corrections; // Number of accepted corrections
+        double m_gamma;        // Scaling of the initial inverse Hessian, sᵀy / yᵀy of the newest correction
+
+        Eigen::MatrixXd m_sy; // sᵢᵀyⱼ by slot, only valid for i older than j
+        Eigen::MatrixXd m_yy; // yᵢᵀyⱼ by slot
+
+        // Work storage, sized in reset
+        Eigen::MatrixXd m_partial_products; // Per row block partial results of the history products
+        Eigen::VectorXd m_products;         // [S Y]ᵀv of the last history product
+        Eigen::VectorXd m_coefficients;     // Coefficients of the history columns in the direction
+        Eigen::MatrixXd m_R;                // Upper triangle of SᵀY in chronological order
+        Eigen::VectorXd m_a, m_b;
+
         TVector m_prev_x;    // Previous x
         TVector m_prev_grad; // Previous gradient
     };
@@ -0,0 +1,178 @@
+#include "MatrixFreeNewton.hpp"
+
+#include <polysolve/Utils.hpp>
+
+#include <cmath>
+
+#if defined(SPDLOG_FMT_EXTERNAL)
+#include <fmt/color.h>
+#else
+#include <spdlog/fmt/bundled/color.h>
+#endif
+
+namespace polysolve::nonlinear
+{
+
+    MatrixFreeNewton::MatrixFreeNewton(const json &solver_params,
+                                       const double characteristic_length,
+                                       spdlog::logger &logger)
+        : Superclass(solver_params, characteristic_length, logger)
+    {
+        tolerance = extract_param("MatrixFreeNewton", "tolerance", solver_params);
+        max_iterations = extract_param("MatrixFreeNewton", "max_iterations", solver_params);
+        const json &params = solver_params.contains("MatrixFreeNewton") ? solver_params["MatrixFreeNewton"] : solver_params;
+        use_preconditioner = params.value("use_preconditioner", true);
+
+        if (tolerance <= 0)
+            log_and_throw_error(logger, "MatrixFreeNewton tolerance must be > 0, instead got {}", tolerance);
+        if (max_iterations <= 0)
+            log_and_throw_error(logger, "MatrixFreeNewton max_iterations must be > 0, instead got {}", max_iterations);
+    }
+
+    void MatrixFreeNewton::reset(const int ndof)
+    {
+        Superclass::reset(ndof);
+        last_iterations = -1;
+    }
+
+    bool MatrixFreeNewton::compute_preconditioner(Problem &objFunc, const TVector &x)
+    {
+        POLYSOLVE_SCOPED_STOPWATCH("preconditioner", this->preconditioner_time, m_logger);
+
+        polysolve::StiffnessMatrix P;
+        if (!use_preconditioner || !objFunc.hessian_preconditioner(x, P))
+            return false;
+
+        preconditioner_solver.reset();
+        inv_diagonal = P.diagonal();
+        if (P.nonZeros() == (inv_diagonal.array() != 0).count())
+        {
+            if (inv_diagonal.minCoeff() <= 0)
+            {
+                m_logger.debug("[{}] preconditioner is not positive definite, not using it", name());
+                return false;
+            }
+            inv_diagonal = inv_diagonal.cwiseInverse();
+            return true;
+        }
+
+        preconditioner_solver = std::make_unique<Eigen::SimplicialLDLT<polysolve::StiffnessMatrix>>(P);
+        if (preconditioner_solver->info() != Eigen::Success || preconditioner_solver->vectorD().minCoeff() <= 0)
+        {
+            m_logger.debug("[{}] preconditioner is not positive definite, not using it", name());
+            preconditioner_solver.reset();
+            return false;
+        }
+        return true;
+    }
+
+    void MatrixFreeNewton::apply_preconditioner(const TVector &r, TVector &z) const
+    {
+        if (!has_preconditioner)
+            z = r;
+        else if (preconditioner_solver)
+            z = preconditioner_solver->solve(r);
+        else
+            z = inv_diagonal.cwiseProduct(r);
+    }
+
+    bool MatrixFreeNewton::compute_update_direction(
+        Problem &objFunc,
+        const TVector &x,
+        const TVector &grad,
+        TVector &direction)
+    {
+        has_preconditioner = compute_preconditioner(objFunc, x);
+
+        POLYSOLVE_SCOPED_STOPWATCH("linear solve", this->inverting_time, m_logger);
+
+        // Preconditioned CG on H Δx = -g starting from Δx = 0, every iterate is a
+        // descent direction as long as the curvature along the search directions is positive
+        const double target_residual = tolerance * grad.norm();
+
+        direction.setZero(grad.size());
+        TVector r = -grad, z, p, hp;
+        apply_preconditioner(r, z);
+        p = z;
+        double rz = r.dot(z);
+        double residual = r.norm();
+
+        int iter = 0;
+        for (; iter < max_iterations && residual > target_residual && !is_cancelled(); ++iter)
+        {
+            objFunc.hessian_vector_product(x, p, hp);
+
+            const double curvature = p.dot(hp);
+            if (!std::isfinite(curvature) || curvature <= 0)
+            {
+                // Stop at the last iterate with positive curvature
+                m_logger.debug("[{}] negative curvature {:g} at CG iteration {}", name(), curvature, iter);
+                if (iter == 0)
+                    return false;
+                break;
+            }
+
+            const double alpha = rz / curvature;
+            direction += alpha * p;
+            r -= alpha * hp;
+            residual = r.norm();
+
+            apply_preconditioner(r, z);
+            const double rz_new = r.dot(z);
+            p = z + (rz_new / rz) * p;
+            rz = rz_new;
+        }
+
+        m_logger.trace("[{}] CG iterations {}, residual {:g}", name(), iter, residual);
+
+        last_iterations = iter;
+        last_residual = residual;
+        last_relative_error = grad.norm() > 0 ? residual / grad.norm() : 0.;
+
+        return std::isfinite(residual);
+    }
+
+    void MatrixFreeNewton::update_solver_info(json &solver_info, const double per_iteration)
+    {
+        Superclass::update_solver_info(solver_info, per_iteration);
+
+        // Only the last solve, the previous ones are in the telemetry
+        json internal_solver = json::array();
+        if (last_iterations >= 0)
+        {
+            json info;
+            info["solver_iter"] = last_iterations;
+            info["solver_error"] = last_relative_error;
+            info["preconditioned"] = has_preconditioner;
+            internal_solver.push_back(info);
+        }
+        solver_info["internal_solver"] = internal_solver;
+        solver_info["time_preconditioner"] = preconditioner_time / per_iteration;
+        solver_info["time_inverting"] = inverting_time / per_iteration;
+    }
+
+    void MatrixFreeNewton::update_iteration_record(IterationRecord &record) const
+    {
+        if (last_iterations < 0)
+            return;
+        record.linear_iterations = last_iterations;
+        record.linear_residual = last_residual;
+    }
+
+    void MatrixFreeNewton::reset_times()
+    {
+        preconditioner_time = 0;
+        inverting_time = 0;
+    }
+
+    void MatrixFreeNewton::log_times() const
+    {
+        if (preconditioner_time <= 0 && inverting_time <= 0)
+            return; // nothing to log
+        m_logger.debug(
+            "[{}][{}] preconditioner: {:.2e}s; linear_solve: {:.2e}s",
+            fmt::format(fmt::fg(fmt::terminal_color::magenta), "timing"),
+            name(), preconditioner_time, inverting_time);
+    }
+
+} // namespace polysolve::nonlinear
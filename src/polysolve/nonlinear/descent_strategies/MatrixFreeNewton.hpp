@@ -0,0 +1,60 @@
+#pragma once
+
+#include "DescentStrategy.hpp"
+#include <polysolve/Utils.hpp>
+
+#include <Eigen/SparseCholesky>
+
+#include <memory>
+
+namespace polysolve::nonlinear
+{
+    /// Newton–Krylov: solves the Newton system with preconditioned conjugate
+    /// gradient on Problem::hessian_vector_product, the Hessian is never assembled.
+    class MatrixFreeNewton : public DescentStrategy
+    {
+    public:
+        using Superclass = DescentStrategy;
+
+        MatrixFreeNewton(const json &solver_params,
+                         const double characteristic_length,
+                         spdlog::logger &logger);
+
+        std::string name() const override { return "MatrixFreeNewton"; }
+
+        bool compute_update_direction(
+            Problem &objFunc,
+            const TVector &x,
+            const TVector &grad,
+            TVector &direction) override;
+
+        void reset(const int ndof) override;
+        void update_solver_info(json &solver_info, const double per_iteration) override;
+        void update_iteration_record(IterationRecord &record) const override;
+        void reset_times() override;
+        void log_times() const override;
+
+    private:
+        /// Sets up the preconditioner from the problem, returns false if there is none
+        bool compute_preconditioner(Problem &objFunc, const TVector &x);
+
+        /// z = M⁻¹ r
+        void apply_preconditioner(const TVector &r, TVector &z) const;
+
+        double tolerance;     ///< Relative residual tolerance ‖HΔx + g‖ ≤ tol ‖g‖
+        int max_iterations;   ///< Maximum number of CG iterations
+        bool use_preconditioner;
+
+        bool has_preconditioner = false;
+        TVector inv_diagonal; ///< Used if the preconditioner is diagonal
+        std::unique_ptr<Eigen::SimplicialLDLT<polysolve::StiffnessMatrix>> preconditioner_solver;
+
+        // Last CG solve, last_iterations is -1 before the first one
+        int last_iterations = -1;
+        double last_residual;
+        double last_relative_error;
+
+        double preconditioner_time;
+        double inverting_time;
+    };
+} // namespace polysolve::nonlinear
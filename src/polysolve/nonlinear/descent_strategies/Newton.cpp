@@ -1,6 +1,11 @@
 #include "Newton.hpp"
 
 #include <polysolve/Utils.hpp>
+#include <polysolve/BinaryIO.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 
 #if defined(SPDLOG_FMT_EXTERNAL)
 #include <fmt/color.h>
@@ -10,6 +15,41 @@
 
 namespace polysolve::nonlinear
 {
+    namespace
+    {
+        /// Position of the diagonal entry of column k in the values of a compressed matrix, -1 if not stored
+        std::ptrdiff_t diagonal_position(const polysolve::StiffnessMatrix &A, const int k)
+        {
+            const auto *begin = A.innerIndexPtr() + A.outerIndexPtr()[k];
+            const auto *end = A.innerIndexPtr() + A.outerIndexPtr()[k + 1];
+            const auto *it = std::lower_bound(begin, end, k);
+            return it != end && *it == k ? it - A.innerIndexPtr() : -1;
+        }
+
+        bool has_full_diagonal(const polysolve::StiffnessMatrix &A)
+        {
+            if (!A.isCompressed() || A.rows() != A.cols())
+                return false;
+            for (int k = 0; k < A.cols(); ++k)
+                if (diagonal_position(A, k) < 0)
+                    return false;
+            return true;
+        }
+
+        /// A += shift I, in place if the diagonal is stored
+        /// @return If the sparsity structure changed
+        bool add_to_diagonal(polysolve::StiffnessMatrix &A, const double shift)
+        {
+            if (!has_full_diagonal(A))
+            {
+                A += shift * sparse_identity(A.rows(), A.cols());
+                return true;
+            }
+            for (int k = 0; k < A.cols(); ++k)
+                A.valuePtr()[diagonal_position(A, k)] += shift;
+            return false;
+        }
+    } // namespace
 
     std::vector<std::shared_ptr<DescentStrategy>> Newton::create_solver(
         const bool sparse,
@@ -21,14 +61,20 @@ namespace polysolve::nonlinear
         // Copies stuff from main newton
         json proj_solver_params = R"({"ProjectedNewton": {}})"_json;
         proj_solver_params["ProjectedNewton"]["residual_tolerance"] = solver_params["Newton"]["residual_tolerance"];
+        proj_solver_params["ProjectedNewton"]["forcing_term"] = solver_params["Newton"]["forcing_term"];
+        proj_solver_params["ProjectedNewton"]["forcing_term_min"] = solver_params["Newton"]["forcing_term_min"];
+        proj_solver_params["ProjectedNewton"]["forcing_term_max"] = solver_params["Newton"]["forcing_term_max"];
 
         json reg_solver_params = R"({"RegularizedNewton": {}})"_json;
         reg_solver_params["RegularizedNewton"]["residual_tolerance"] = solver_params["Newton"]["residual_tolerance"];
+        reg_solver_params["RegularizedNewton"]["forcing_term"] = solver_params["Newton"]["forcing_term"];
+        reg_solver_params["RegularizedNewton"]["forcing_term_min"] = solver_params["Newton"]["forcing_term_min"];
+        reg_solver_params["RegularizedNewton"]["forcing_term_max"] = solver_params["Newton"]["forcing_term_max"];
         reg_solver_params["RegularizedNewton"]["reg_weight_min"] = solver_params["Newton"]["reg_weight_min"];
         reg_solver_params["RegularizedNewton"]["reg_weight_max"] = solver_params["Newton"]["reg_weight_max"];
         reg_solver_params["RegularizedNewton"]["reg_weight_inc"] = solver_params["Newton"]["reg_weight_inc"];
 
-        std::vector<std::shared_ptr<DescentStrategy>> res;
+        std::vector<std::shared_ptr<Newton>> res;
         const bool force_psd_projection = solver_params["Newton"]["force_psd_projection"];
         if (!force_psd_projection)
             res.push_back(std::make_unique<Newton>(
@@ -53,24 +99,46 @@ namespace polysolve::nonlinear
         if (res.empty())
             log_and_throw_error(logger, "Newton needs to have at least one of force_psd_projection=false, reg_weight_min>0, or use_psd_projection=true");
 
-        return res;
+        // Only one of them is active at a time, they can use the same Hessian storage
+        for (auto &s : res)
+            s->hessian_buffer = res.front()->hessian_buffer;
+
+        return std::vector<std::shared_ptr<DescentStrategy>>(res.begin(), res.end());
     }
 
     Newton::Newton(const bool sparse,
-                   const double residual_tolerance,
+                   const std::string &params_key,
                    const json &solver_params,
                    const json &linear_solver_params,
                    const double characteristic_length,
                    spdlog::logger &logger)
         : Superclass(solver_params, characteristic_length, logger),
-          is_sparse(sparse), characteristic_length(characteristic_length), residual_tolerance(residual_tolerance)
+          is_sparse(sparse), characteristic_length(characteristic_length),
+          hessian_buffer(std::make_shared<HessianBuffer>())
     {
         linear_solver = polysolve::linear::Solver::create(linear_solver_params, logger);
         if (linear_solver->is_dense() == sparse)
             log_and_throw_error(logger, "Newton linear solver must be {}, instead got {}", sparse ? "sparse" : "dense", linear_solver->name());
 
+        residual_tolerance = extract_param(params_key, "residual_tolerance", solver_params);
         if (residual_tolerance <= 0)
             log_and_throw_error(logger, "Newton residual_tolerance must be > 0, instead got {}", residual_tolerance);
+
+        const json &params = solver_params.contains(params_key) ? solver_params[params_key] : solver_params;
+        const std::string forcing_term_name = params.value("forcing_term", "None");
+        if (forcing_term_name == "None")
+            forcing_term = ForcingTerm::None;
+        else if (forcing_term_name == "EisenstatWalker1")
+            forcing_term = ForcingTerm::EisenstatWalker1;
+        else if (forcing_term_name == "EisenstatWalker2")
+            forcing_term = ForcingTerm::EisenstatWalker2;
+        else
+            log_and_throw_error(logger, "Unknown Newton forcing_term {}", forcing_term_name);
+
+        forcing_term_min = params.value("forcing_term_min", 1e-10);
+        forcing_term_max = params.value("forcing_term_max", 0.9);
+        if (forcing_term_min <= 0 || forcing_term_max >= 1 || forcing_term_min > forcing_term_max)
+            log_and_throw_error(logger, "Newton forcing terms must satisfy 0 < forcing_term_min ≤ forcing_term_max < 1, instead got {} and {}", forcing_term_min, forcing_term_max);
     }
 
     Newton::Newton(
@@ -79,7 +147,7 @@ namespace polysolve::nonlinear
         const json &linear_solver_params,
         const double characteristic_length,
         spdlog::logger &logger)
-        : Newton(sparse, extract_param("Newton", "residual_tolerance", solver_params), solver_params, linear_solver_params, characteristic_length, logger)
+        : Newton(sparse, "Newton", solver_params, linear_solver_params, characteristic_length, logger)
     {
     }
 
@@ -89,7 +157,7 @@ namespace polysolve::nonlinear
         const json &linear_solver_params,
         const double characteristic_length,
         spdlog::logger &logger)
-        : Superclass(sparse, extract_param("ProjectedNewton", "residual_tolerance", solver_params), solver_params, linear_solver_params, characteristic_length, logger)
+        : Superclass(sparse, "ProjectedNewton", solver_params, linear_solver_params, characteristic_length, logger)
     {
     }
 
@@ -100,7 +168,7 @@ namespace polysolve::nonlinear
         const json &linear_solver_params,
         const double characteristic_length,
         spdlog::logger &logger)
-        : Superclass(sparse, extract_param("RegularizedNewton", "residual_tolerance", solver_params), solver_params, linear_solver_params, characteristic_length, logger),
+        : Superclass(sparse, "RegularizedNewton", solver_params, linear_solver_params, characteristic_length, logger),
           project_to_psd(project_to_psd)
     {
         reg_weight_min = extract_param("RegularizedNewton", "reg_weight_min", solver_params);
@@ -108,6 +176,7 @@ namespace polysolve::nonlinear
         reg_weight_inc = extract_param("RegularizedNewton", "reg_weight_inc", solver_params);
 
         reg_weight = reg_weight_min;
+        successful_reg_weight = reg_weight_min;
 
         if (reg_weight_min <= 0)
             log_and_throw_error(logger, "Newton reg_weight_min must be  > 0, instead got {}", reg_weight_min);
@@ -121,35 +190,161 @@ namespace polysolve::nonlinear
 
     // =======================================================================
 
+    void Newton::set_cancellation_token(const std::shared_ptr<const CancellationToken> &token)
+    {
+        Superclass::set_cancellation_token(token);
+        linear_solver->set_cancellation_token(token);
+    }
+
     void Newton::reset(const int ndof)
     {
         Superclass::reset(ndof);
-        internal_solver_info = json::array();
+        last_residual = -1;
+
+        prev_forcing_term = forcing_term_max;
+        prev_grad_norm = -1;
+        prev_linear_residual = -1;
+        prev_direction.resize(0);
+
+        // The problem might have changed, query its Hessian pattern again
+        hessian_buffer->pattern_checked = false;
+        hessian_buffer->owner = nullptr;
+        analyzed_structure = -1;
     }
 
     void RegularizedNewton::reset(const int ndof)
     {
         Superclass::reset(ndof);
-        reg_weight = reg_weight_min;
+        reg_weight = successful_reg_weight = reg_weight_min;
+        regularization_exhausted = false;
+        x_cache.resize(0);
+    }
+
+    void RegularizedNewton::restart(const int ndof)
+    {
+        Superclass::reset(ndof);
+        // Start one step below the last shift that worked, instead of climbing from the minimum again
+        reg_weight = std::max(reg_weight_min, successful_reg_weight / reg_weight_inc);
+        regularization_exhausted = false;
+        x_cache.resize(0);
+    }
+
+    void Newton::warm_start(const int ndof)
+    {
+        last_residual = -1;
+
+        // The gradients of the new problem are not comparable to the previous ones,
+        // only the last direction is kept as initial guess of the iterative solvers
+        prev_forcing_term = forcing_term_max;
+        prev_grad_norm = -1;
+        prev_linear_residual = -1;
+
+        // Keep the Hessian pattern and the symbolic analysis, only the values are stale
+        hessian_buffer->owner = nullptr;
+    }
+
+    void RegularizedNewton::warm_start(const int ndof)
+    {
+        Superclass::warm_start(ndof);
+        reg_weight = std::max(reg_weight_min, successful_reg_weight / reg_weight_inc);
+        x_cache.resize(0);
+    }
+
+    void Newton::save_state(std::ostream &out) const
+    {
+        // The Hessian is assembled again, only the forcing term history is kept
+        write_value(out, prev_forcing_term);
+        write_value(out, prev_grad_norm);
+        write_value(out, prev_linear_residual);
+        write_dense(out, prev_direction);
+    }
+
+    void Newton::load_state(std::istream &in)
+    {
+        read_value(in, prev_forcing_term);
+        read_value(in, prev_grad_norm);
+        read_value(in, prev_linear_residual);
+        read_dense(in, prev_direction);
+    }
+
+    void RegularizedNewton::save_state(std::ostream &out) const
+    {
+        Superclass::save_state(out);
+        write_value(out, reg_weight);
+        write_value(out, successful_reg_weight);
+    }
+
+    void RegularizedNewton::load_state(std::istream &in)
+    {
+        Superclass::load_state(in);
+        read_value(in, reg_weight);
+        read_value(in, successful_reg_weight);
     }
 
     // =======================================================================
 
+    double Newton::compute_forcing_term(const double grad_norm) const
+    {
+        if (prev_grad_norm <= 0)
+            return forcing_term_max;
+
+        // Safeguards of Eisenstat and Walker, prevent η from decreasing too fast
+        double eta, safeguard;
+        if (forcing_term == ForcingTerm::EisenstatWalker1)
+        {
+            const double alpha = (1 + std::sqrt(5.0)) / 2;
+            eta = std::abs(grad_norm - prev_linear_residual) / prev_grad_norm;
+            safeguard = std::pow(prev_forcing_term, alpha);
+        }
+        else
+        {
+            assert(forcing_term == ForcingTerm::EisenstatWalker2);
+            const double gamma = 0.9, alpha = 2;
+            eta = gamma * std::pow(grad_norm / prev_grad_norm, alpha);
+            safeguard = gamma * std::pow(prev_forcing_term, alpha);
+        }
+        if (safeguard > 0.1)
+            eta = std::max(eta, safeguard);
+
+        return std::clamp(eta, forcing_term_min, forcing_term_max);
+    }
+
     bool Newton::compute_update_direction(
         Problem &objFunc,
         const TVector &x,
         const TVector &grad,
         TVector &direction)
     {
+        const double grad_norm = grad.norm();
+
+        double tolerance = residual_tolerance * characteristic_length;
+        double eta = 0;
+        if (forcing_term != ForcingTerm::None)
+        {
+            eta = compute_forcing_term(grad_norm);
+            linear_solver->set_tolerance(eta);
+            // Forcing condition ‖HΔx + ∇f‖ ≤ η‖∇f‖. The Krylov residual is recursive, allow it to
+            // drift from the true one, but strictly below ‖∇f‖ which even Δx = 0 reaches
+            tolerance = std::min(std::max(tolerance, 2 * eta * grad_norm), 0.5 * (1 + eta) * grad_norm);
+
+            // Iterative solvers start from the previous direction
+            if (prev_direction.size() == grad.size())
+                direction = prev_direction;
+            else
+                direction.setZero(grad.size());
+        }
+
         const double residual =
             is_sparse ? solve_sparse_linear_system(objFunc, x, grad, direction)
                       : solve_dense_linear_system(objFunc, x, grad, direction);
+        last_residual = residual;
 
-        if (std::isnan(residual) || residual > residual_tolerance * characteristic_length)
+        if (std::isnan(residual) || residual > tolerance)
         {
             m_logger.debug("[{}] large (or nan) linear solve residual {}>{} (‖∇f‖={})",
-                           name(), residual, residual_tolerance * characteristic_length, grad.norm());
+                           name(), residual, tolerance, grad_norm);
 
+            prev_direction.resize(0);
             return false;
         }
         else
@@ -157,6 +352,14 @@ namespace polysolve::nonlinear
             m_logger.trace("linear solve residual {}", residual);
         }
 
+        if (forcing_term != ForcingTerm::None)
+        {
+            prev_forcing_term = eta;
+            prev_grad_norm = grad_norm;
+            prev_linear_residual = residual;
+            prev_direction = direction;
+        }
+
         return true;
     }
 
@@ -167,7 +370,7 @@ namespace polysolve::nonlinear
                                               const TVector &grad,
                                               TVector &direction)
     {
-        polysolve::StiffnessMatrix hessian;
+        polysolve::StiffnessMatrix &hessian = hessian_buffer->sparse;
 
         {
             POLYSOLVE_SCOPED_STOPWATCH("assembly time", this->assembly_time, m_logger);
@@ -176,8 +379,13 @@ namespace polysolve::nonlinear
 
         {
             POLYSOLVE_SCOPED_STOPWATCH("linear solve", this->inverting_time, m_logger);
-            // TODO: get the correct size
-            linear_solver->analyze_pattern(hessian, hessian.rows());
+            // The symbolic analysis is reused as long as the structure does not change
+            if (analyzed_structure != hessian_buffer->structure)
+            {
+                // TODO: get the correct size
+                linear_solver->analyze_pattern(hessian, hessian.rows());
+                analyzed_structure = hessian_buffer->structure;
+            }
 
             try
             {
@@ -195,13 +403,7 @@ namespace polysolve::nonlinear
             linear_solver->solve(-grad, direction); // H Δx = -g
         }
 
-        const double residual = (hessian * direction + grad).norm(); // H Δx + g = 0
-
-        json info;
-        linear_solver->get_info(info);
-        internal_solver_info.push_back(info);
-
-        return residual;
+        return (hessian * direction + grad).norm(); // H Δx + g = 0
     }
 
     double Newton::solve_dense_linear_system(Problem &objFunc,
@@ -209,20 +411,33 @@ namespace polysolve::nonlinear
                                              const TVector &grad,
                                              TVector &direction)
     {
-        Eigen::MatrixXd hessian;
+        Eigen::MatrixXd &hessian = hessian_buffer->dense;
 
         {
             POLYSOLVE_SCOPED_STOPWATCH("assembly time", this->assembly_time, m_logger);
             compute_hessian(objFunc, x, hessian);
         }
 
+        // Factorize in the Hessian storage when the solver keeps the strict
+        // upper triangle, the residual is then computed from it and the diagonal
+        const bool inplace = factorizes_dense_inplace();
+        Eigen::VectorXd diagonal;
+
         {
             POLYSOLVE_SCOPED_STOPWATCH("linear solve", this->inverting_time, m_logger);
 
             try
             {
                 linear_solver->analyze_pattern_dense(hessian, hessian.rows());
-                linear_solver->factorize_dense(hessian);
+                if (inplace)
+                {
+                    diagonal = hessian.diagonal();
+                    linear_solver->factorize_dense_inplace(hessian);
+                }
+                else
+                {
+                    linear_solver->factorize_dense(hessian);
+                }
                 linear_solver->solve(-grad, direction);
             }
             catch (const std::runtime_error &err)
@@ -235,23 +450,65 @@ namespace polysolve::nonlinear
             }
         }
 
-        const double residual = (hessian * direction + grad).norm(); // H Δx + g = 0
-
-        json info;
-        linear_solver->get_info(info);
-        internal_solver_info.push_back(info);
+        double residual;
+        if (inplace)
+        {
+            TVector r = diagonal.cwiseProduct(direction) + grad;
+            r.noalias() += hessian.triangularView<Eigen::StrictlyUpper>() * direction;
+            r.noalias() += hessian.triangularView<Eigen::StrictlyUpper>().transpose() * direction;
+            residual = r.norm(); // H Δx + g = 0
+        }
+        else
+        {
+            residual = (hessian * direction + grad).norm(); // H Δx + g = 0
+        }
 
         return residual;
     }
     // =======================================================================
 
+    void Newton::assemble_hessian(Problem &objFunc,
+                                  const TVector &x,
+                                  polysolve::StiffnessMatrix &hessian)
+    {
+        HessianBuffer &buffer = *hessian_buffer;
+        if (!buffer.pattern_checked)
+        {
+            buffer.pattern_checked = true;
+            ++buffer.structure;
+            buffer.has_pattern = objFunc.hessian_pattern(hessian);
+            if (buffer.has_pattern)
+            {
+                hessian.makeCompressed();
+                // Regularization shifts the diagonal in place, it has to be part of the pattern
+                if (!has_full_diagonal(hessian))
+                {
+                    m_logger.debug("[{}] Hessian pattern is missing diagonal entries, not using it", name());
+                    buffer.has_pattern = false;
+                }
+            }
+        }
+
+        if (buffer.has_pattern)
+        {
+            Eigen::Map<Eigen::VectorXd> values(hessian.valuePtr(), hessian.nonZeros());
+            objFunc.hessian_values(x, values);
+        }
+        else
+        {
+            objFunc.hessian(x, hessian);
+            ++buffer.structure;
+        }
+        buffer.owner = this;
+    }
+
     void Newton::compute_hessian(Problem &objFunc,
                                  const TVector &x,
                                  polysolve::StiffnessMatrix &hessian)
 
     {
         objFunc.set_project_to_psd(false);
-        objFunc.hessian(x, hessian);
+        assemble_hessian(objFunc, x, hessian);
     }
 
     void ProjectedNewton::compute_hessian(Problem &objFunc,
@@ -260,7 +517,7 @@ namespace polysolve::nonlinear
 
     {
         objFunc.set_project_to_psd(true);
-        objFunc.hessian(x, hessian);
+        assemble_hessian(objFunc, x, hessian);
     }
 
     void RegularizedNewton::compute_hessian(Problem &objFunc,
@@ -268,16 +525,20 @@ namespace polysolve::nonlinear
                                             polysolve::StiffnessMatrix &hessian)
 
     {
-        if (x.size() != x_cache.size() || x != x_cache)
+        if (!owns_hessian() || x.size() != x_cache.size() || x != x_cache)
         {
             objFunc.set_project_to_psd(project_to_psd);
-            objFunc.hessian(x, hessian_cache);
+            assemble_hessian(objFunc, x, hessian);
             x_cache = x;
+            applied_reg_weight = 0;
         }
-        hessian = hessian_cache;
-        if (reg_weight > 0)
+
+        // Only the shift changes between attempts at the same point
+        if (reg_weight != applied_reg_weight)
         {
-            hessian += reg_weight * sparse_identity(hessian.rows(), hessian.cols());
+            if (add_to_diagonal(hessian, reg_weight - applied_reg_weight))
+                ++hessian_buffer->structure;
+            applied_reg_weight = reg_weight;
         }
     }
 
@@ -288,6 +549,7 @@ namespace polysolve::nonlinear
     {
         objFunc.set_project_to_psd(false);
         objFunc.hessian(x, hessian);
+        hessian_buffer->owner = this;
     }
 
     void ProjectedNewton::compute_hessian(Problem &objFunc,
@@ -297,6 +559,7 @@ namespace polysolve::nonlinear
     {
         objFunc.set_project_to_psd(true);
         objFunc.hessian(x, hessian);
+        hessian_buffer->owner = this;
     }
 
     void RegularizedNewton::compute_hessian(Problem &objFunc,
@@ -304,17 +567,64 @@ namespace polysolve::nonlinear
                                             Eigen::MatrixXd &hessian)
 
     {
-        objFunc.set_project_to_psd(project_to_psd);
-        objFunc.hessian(x, hessian);
-        if (reg_weight > 0)
+        if (!owns_hessian() || x.size() != x_cache.size() || x != x_cache)
+        {
+            objFunc.set_project_to_psd(project_to_psd);
+            objFunc.hessian(x, hessian);
+            hessian_buffer->owner = this;
+            x_cache = x;
+            dense_diagonal = hessian.diagonal();
+        }
+        else if (factorizes_dense_inplace())
         {
-            for (int k = 0; k < x.size(); k++)
-                hessian(k, k) += reg_weight;
+            // The last in-place factorization overwrote the lower triangle, the upper one is intact
+            for (Eigen::Index j = 0; j + 1 < hessian.cols(); ++j)
+                hessian.col(j).tail(hessian.rows() - j - 1) = hessian.row(j).tail(hessian.cols() - j - 1).transpose();
         }
+        // Otherwise the factorization worked on a copy and only the shift needs to change
+
+        // Only the shift changes between attempts at the same point
+        hessian.diagonal() = dense_diagonal.array() + reg_weight;
     }
     // =======================================================================
 
+    bool RegularizedNewton::compute_update_direction(
+        Problem &objFunc,
+        const TVector &x,
+        const TVector &grad,
+        TVector &direction)
+    {
+        regularization_exhausted = false;
+
+        // At the same point the Hessian and its symbolic analysis are reused,
+        // only the shift of the diagonal changes
+        while (!Superclass::compute_update_direction(objFunc, x, grad, direction))
+        {
+            if (is_cancelled())
+                return false;
+            if (!increase_reg_weight())
+            {
+                regularization_exhausted = true;
+                return false;
+            }
+            m_logger.debug("[{}] retrying with a larger regularization", name());
+        }
+
+        successful_reg_weight = reg_weight;
+        return true;
+    }
+
     bool RegularizedNewton::handle_error()
+    {
+        if (regularization_exhausted)
+        {
+            regularization_exhausted = false;
+            return false;
+        }
+        return increase_reg_weight();
+    }
+
+    bool RegularizedNewton::increase_reg_weight()
     {
         reg_weight *= reg_weight_inc;
         return reg_weight < reg_weight_max;
@@ -325,11 +635,36 @@ namespace polysolve::nonlinear
     {
         Superclass::update_solver_info(solver_info, per_iteration);
 
-        solver_info["internal_solver"] = internal_solver_info;
+        // Only the last solve, the previous ones are in the telemetry
+        json internal_solver = json::array();
+        if (last_residual >= 0 || std::isnan(last_residual))
+        {
+            json info;
+            linear_solver->get_info(info);
+            if (forcing_term != ForcingTerm::None)
+                info["forcing_term"] = prev_forcing_term;
+            internal_solver.push_back(info);
+        }
+        solver_info["internal_solver"] = internal_solver;
         solver_info["time_assembly"] = assembly_time / per_iteration;
         solver_info["time_inverting"] = inverting_time / per_iteration;
     }
 
+    void RegularizedNewton::update_solver_info(json &solver_info, const double per_iteration)
+    {
+        Superclass::update_solver_info(solver_info, per_iteration);
+        solver_info["reg_weight"] = reg_weight;
+    }
+
+    void Newton::update_iteration_record(IterationRecord &record) const
+    {
+        if (last_residual >= 0)
+        {
+            record.linear_residual = last_residual;
+            record.linear_iterations = linear_solver->iterations();
+        }
+    }
+
     void Newton::reset_times()
     {
         assembly_time = 0;
@@ -21,7 +21,7 @@ namespace polysolve::nonlinear
 
     protected:
         Newton(const bool sparse,
-               const double residual_tolerance,
+               const std::string &params_key,
                const json &solver_params,
                const json &linear_solver_params,
                const double characteristic_length,
@@ -36,6 +36,8 @@ namespace polysolve::nonlinear
 
         std::string name() const override { return internal_name() + "Newton"; }
 
+        void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) override;
+
     private:
         double solve_sparse_linear_system(Problem &objFunc,
                                           const TVector &x, const TVector &grad,
@@ -44,18 +46,64 @@ namespace polysolve::nonlinear
                                          const TVector &x, const TVector &grad,
                                          TVector &direction);
 
-        json internal_solver_info = json::array();
+        /// Linear tolerance η of the next solve, ‖HΔx + g‖ ≤ η‖g‖
+        double compute_forcing_term(const double grad_norm) const;
+
+        /// Residual of the last linear solve, -1 before the first one and NaN if it failed
+        double last_residual = -1;
+
+        /// HessianBuffer::structure of the last symbolic analysis of linear_solver
+        int analyzed_structure = -1;
 
         const bool is_sparse;
         const double characteristic_length;
         double residual_tolerance;
 
+        /// Inexact Newton forcing terms (Eisenstat and Walker 1996)
+        enum class ForcingTerm
+        {
+            None,
+            EisenstatWalker1, ///< η = |‖gₖ‖ - ‖gₖ₋₁ + Hₖ₋₁Δxₖ₋₁‖| / ‖gₖ₋₁‖
+            EisenstatWalker2, ///< η = γ (‖gₖ‖ / ‖gₖ₋₁‖)^α
+        };
+        ForcingTerm forcing_term;
+        double forcing_term_min;
+        double forcing_term_max;
+
+        // State of the previous successful solve
+        double prev_forcing_term;
+        double prev_grad_norm;
+        double prev_linear_residual;
+        TVector prev_direction; ///< Warm start of the iterative solvers
+
         std::unique_ptr<polysolve::linear::Solver> linear_solver; ///< Linear solver used to solve the linear system
 
         double assembly_time;
         double inverting_time;
 
     protected:
+        /// Hessian storage reused across iterations, shared by the Newton variants
+        /// created together since only one of them is active at a time
+        struct HessianBuffer
+        {
+            polysolve::StiffnessMatrix sparse;
+            Eigen::MatrixXd dense;
+            const Newton *owner = nullptr; ///< Strategy that assembled the stored Hessian
+            int structure = 0;             ///< Incremented whenever the sparsity structure might change
+            bool pattern_checked = false;
+            bool has_pattern = false; ///< The sparse values are refilled by Problem::hessian_values
+        };
+        std::shared_ptr<HessianBuffer> hessian_buffer;
+
+        /// Assembles the sparse Hessian in place, only refilling its values if the problem has a fixed pattern
+        void assemble_hessian(Problem &objFunc, const TVector &x, polysolve::StiffnessMatrix &hessian);
+
+        /// If the buffer holds the last Hessian assembled by this strategy
+        bool owns_hessian() const { return hessian_buffer->owner == this; }
+
+        /// If the dense Hessian is factorized in its storage, overwriting its lower triangle
+        bool factorizes_dense_inplace() const { return linear_solver->factorize_dense_preserves_upper(); }
+
         std::string internal_name() const { return is_sparse ? "Sparse" : "Dense"; }
 
         virtual void compute_hessian(Problem &objFunc,
@@ -70,7 +118,11 @@ namespace polysolve::nonlinear
         bool compute_update_direction(Problem &objFunc, const TVector &x, const TVector &grad, TVector &direction) override;
 
         void reset(const int ndof) override;
+        void warm_start(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
         void update_solver_info(json &solver_info, const double per_iteration) override;
+        void update_iteration_record(IterationRecord &record) const override;
         void reset_times() override;
         void log_times() const override;
     };
@@ -114,7 +166,18 @@ namespace polysolve::nonlinear
             return fmt::format("{}RegularizedNewton (reg_weight={:g})", internal_name(), reg_weight);
         }
 
+        /// Retries with a larger shift while the factorization fails, only refactorizing
+        /// the diagonally shifted Hessian. If it still fails at reg_weight_max, the following
+        /// handle_error does not raise the shift again and lets the solver fall back.
+        bool compute_update_direction(Problem &objFunc, const TVector &x, const TVector &grad, TVector &direction) override;
+
         void reset(const int ndof) override;
+        /// Keeps the last successful shift, as warm_start
+        void restart(const int ndof) override;
+        void warm_start(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
+        void update_solver_info(json &solver_info, const double per_iteration) override;
         bool handle_error() override;
 
     private:
@@ -123,10 +186,17 @@ namespace polysolve::nonlinear
         double reg_weight_max;
         double reg_weight_inc;
 
-        TVector x_cache;
-        polysolve::StiffnessMatrix hessian_cache;
+        TVector x_cache;           ///< Point of the Hessian in the buffer
+        double applied_reg_weight; ///< Shift currently added to its diagonal
+        TVector dense_diagonal;    ///< Unshifted diagonal of the dense Hessian at x_cache, an in-place factorization overwrites it
+
+        double reg_weight;            ///< Regularization Coefficients
+        double successful_reg_weight; ///< Last shift giving a direction, where the next solve starts
+
+        /// compute_update_direction already raised reg_weight up to reg_weight_max
+        bool regularization_exhausted = false;
 
-        double reg_weight; ///< Regularization Coefficients
+        bool increase_reg_weight();
     protected:
         void compute_hessian(Problem &objFunc,
                              const TVector &x,
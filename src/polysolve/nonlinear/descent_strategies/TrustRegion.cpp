@@ -0,0 +1,316 @@
+#include "TrustRegion.hpp"
+
+#include <polysolve/Utils.hpp>
+#include <polysolve/BinaryIO.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(SPDLOG_FMT_EXTERNAL)
+#include <fmt/color.h>
+#else
+#include <spdlog/fmt/bundled/color.h>
+#endif
+
+namespace polysolve::nonlinear
+{
+    namespace
+    {
+        const json &trust_region_params(const json &solver_params)
+        {
+            return solver_params.contains("TrustRegion") ? solver_params["TrustRegion"] : solver_params;
+        }
+
+        /// Largest τ ≥ 0 such that ‖p + τd‖ = radius, assuming ‖p‖ ≤ radius
+        double to_boundary(const Eigen::VectorXd &p, const Eigen::VectorXd &d, const double radius)
+        {
+            const double a = d.squaredNorm();
+            const double b = 2 * p.dot(d);
+            const double c = p.squaredNorm() - radius * radius;
+            return (-b + std::sqrt(std::max(b * b - 4 * a * c, 0.0))) / (2 * a);
+        }
+    } // namespace
+
+    TrustRegion::TrustRegion(const json &solver_params,
+                             const json &linear_solver_params,
+                             const double characteristic_length,
+                             spdlog::logger &logger)
+        : Superclass(solver_params, characteristic_length, logger),
+          is_dogleg(trust_region_params(solver_params).value("subproblem", "SteihaugCG") == "Dogleg")
+    {
+        const std::string subproblem = trust_region_params(solver_params).value("subproblem", "SteihaugCG");
+        if (subproblem != "SteihaugCG" && subproblem != "Dogleg")
+            log_and_throw_error(logger, "Unknown TrustRegion subproblem {}", subproblem);
+
+        initial_radius = extract_param("TrustRegion", "initial_radius", solver_params) * characteristic_length;
+        max_radius = extract_param("TrustRegion", "max_radius", solver_params) * characteristic_length;
+        min_radius = extract_param("TrustRegion", "min_radius", solver_params) * characteristic_length;
+        eta = extract_param("TrustRegion", "eta", solver_params);
+
+        if (initial_radius <= 0 || min_radius <= 0 || max_radius < initial_radius)
+            log_and_throw_error(logger, "TrustRegion radii must satisfy 0 < min_radius and 0 < initial_radius ≤ max_radius");
+        if (eta < 0 || eta >= 0.25)
+            log_and_throw_error(logger, "TrustRegion eta must be in [0, 0.25), instead got {}", eta);
+
+        if (is_dogleg)
+        {
+            linear_solver = polysolve::linear::Solver::create(linear_solver_params, logger);
+            if (linear_solver->is_dense())
+                log_and_throw_error(logger, "TrustRegion linear solver must be sparse, instead got {}", linear_solver->name());
+        }
+    }
+
+    void TrustRegion::set_cancellation_token(const std::shared_ptr<const CancellationToken> &token)
+    {
+        Superclass::set_cancellation_token(token);
+        if (linear_solver)
+            linear_solver->set_cancellation_token(token);
+    }
+
+    void TrustRegion::reset(const int ndof)
+    {
+        Superclass::reset(ndof);
+        radius = initial_radius;
+        rejected_steps = 0;
+        has_factorization = false;
+    }
+
+    void TrustRegion::warm_start(const int ndof)
+    {
+        // Keep the radius
+        rejected_steps = 0;
+        has_factorization = false;
+    }
+
+    void TrustRegion::save_state(std::ostream &out) const
+    {
+        write_value(out, radius);
+    }
+
+    void TrustRegion::load_state(std::istream &in)
+    {
+        read_value(in, radius);
+    }
+
+    // =======================================================================
+
+    void TrustRegion::solve_steihaug_cg(Problem &objFunc, const TVector &x, const TVector &grad, Step &step) const
+    {
+        const double grad_norm = grad.norm();
+        const double tolerance = std::min(0.5, std::sqrt(grad_norm)) * grad_norm;
+
+        step.p.setZero(grad.size());
+        TVector hp = TVector::Zero(grad.size()); // H p
+        TVector r = grad, d = -grad, hd;
+
+        for (int k = 0; k < grad.size() && !is_cancelled(); ++k)
+        {
+            objFunc.hessian_vector_product(x, d, hd);
+            const double curvature = d.dot(hd);
+
+            if (!std::isfinite(curvature))
+                break;
+
+            const double alpha = curvature > 0 ? r.squaredNorm() / curvature : 0;
+            if (curvature <= 0 || (step.p + alpha * d).norm() >= radius)
+            {
+                // Negative curvature or outside the region, stop on the boundary
+                const double tau = to_boundary(step.p, d, radius);
+                step.p += tau * d;
+                hp += tau * hd;
+                break;
+            }
+
+            step.p += alpha * d;
+            hp += alpha * hd;
+
+            const double rr = r.squaredNorm();
+            r += alpha * hd;
+            if (r.norm() < tolerance)
+                break;
+
+            d = -r + (r.squaredNorm() / rr) * d;
+        }
+
+        step.g_dot_p = grad.dot(step.p);
+        step.p_H_p = step.p.dot(hp);
+    }
+
+    void TrustRegion::prepare_dogleg(Problem &objFunc, const TVector &x, const TVector &grad)
+    {
+        {
+            POLYSOLVE_SCOPED_STOPWATCH("assembly time", this->assembly_time, m_logger);
+            objFunc.set_project_to_psd(false);
+            objFunc.hessian(x, hessian);
+        }
+
+        POLYSOLVE_SCOPED_STOPWATCH("linear solve", this->inverting_time, m_logger);
+
+        // Cauchy point: minimizer of the model along -g, unbounded if the curvature is not positive
+        const double curvature = grad.dot(hessian * grad);
+        has_cauchy_point = curvature > 0;
+        if (has_cauchy_point)
+            cauchy_point = -(grad.squaredNorm() / curvature) * grad;
+
+        // Newton point, only usable if the Hessian is positive definite along it
+        has_newton_point = false;
+        try
+        {
+            linear_solver->analyze_pattern(hessian, hessian.rows());
+            linear_solver->factorize(hessian);
+            newton_point.setZero(grad.size());
+            linear_solver->solve(-grad, newton_point);
+            has_newton_point = newton_point.allFinite()
+                               && newton_point.dot(grad) < 0
+                               && newton_point.dot(hessian * newton_point) > 0;
+        }
+        catch (const std::runtime_error &err)
+        {
+            m_logger.debug("[{}] Unable to factorize Hessian: \"{}\"", name(), err.what());
+        }
+
+        has_factorization = true;
+    }
+
+    void TrustRegion::solve_dogleg(const TVector &grad, Step &step) const
+    {
+        if (has_newton_point && newton_point.norm() <= radius)
+        {
+            step.p = newton_point;
+        }
+        else if (has_cauchy_point && cauchy_point.norm() < radius)
+        {
+            step.p = cauchy_point;
+            if (has_newton_point)
+            {
+                const TVector d = newton_point - cauchy_point;
+                step.p += to_boundary(cauchy_point, d, radius) * d;
+            }
+        }
+        else
+        {
+            // Steepest descent, truncated at the boundary
+            step.p = -(radius / grad.norm()) * grad;
+        }
+
+        step.g_dot_p = grad.dot(step.p);
+        step.p_H_p = step.p.dot(hessian * step.p);
+    }
+
+    // =======================================================================
+
+    bool TrustRegion::compute_update_direction(
+        Problem &objFunc,
+        const TVector &x,
+        const TVector &grad,
+        TVector &direction)
+    {
+        const double energy = objFunc.value(x);
+
+        if (is_dogleg)
+            prepare_dogleg(objFunc, x, grad);
+
+        Step step;
+        while (true)
+        {
+            if (is_dogleg)
+            {
+                solve_dogleg(grad, step);
+            }
+            else
+            {
+                POLYSOLVE_SCOPED_STOPWATCH("linear solve", this->inverting_time, m_logger);
+                solve_steihaug_cg(objFunc, x, grad, step);
+            }
+
+            // Restrict the step to the feasible part given by the problem (e.g., collision free)
+            objFunc.line_search_begin(x, x + step.p);
+            const double max_step = std::min(1.0, objFunc.max_step_size(x, x + step.p));
+            const double predicted = step.predicted_decrease(max_step);
+            step.p *= max_step;
+
+            const TVector x1 = x + step.p;
+            objFunc.solution_changed(x1);
+            const double new_energy = objFunc.value(x1);
+            const bool valid = std::isfinite(new_energy) && objFunc.is_step_valid(x, x1);
+            objFunc.line_search_end();
+
+            const double actual = energy - new_energy;
+            double rho = -1;
+            if (valid && std::abs(actual - predicted) <= 10 * std::numeric_limits<double>::epsilon() * std::max(1.0, std::abs(energy)))
+                rho = 1; // both decreases are at round-off level, trust the model
+            else if (valid && predicted > 0)
+                rho = actual / predicted;
+            const double step_norm = step.p.norm();
+
+            m_logger.trace("[{}] radius={:g} ‖p‖={:g} ρ={:g}", name(), radius, step_norm, rho);
+
+            if (rho < 0.25)
+                radius = 0.25 * step_norm;
+            else if (rho > 0.75 && step_norm >= 0.99 * radius)
+                radius = std::min(2 * radius, max_radius);
+
+            if (rho > eta)
+            {
+                direction = step.p;
+                return true;
+            }
+
+            ++rejected_steps;
+            if (is_cancelled())
+            {
+                objFunc.solution_changed(x);
+                return false;
+            }
+            if (!(radius >= min_radius))
+            {
+                m_logger.debug("[{}] trust region radius {:g} below {:g}", name(), radius, min_radius);
+                objFunc.solution_changed(x);
+                radius = initial_radius;
+                return false;
+            }
+        }
+    }
+
+    // =======================================================================
+
+    void TrustRegion::update_solver_info(json &solver_info, const double per_iteration)
+    {
+        Superclass::update_solver_info(solver_info, per_iteration);
+
+        solver_info["trust_region_radius"] = radius;
+        solver_info["trust_region_rejected_steps"] = rejected_steps;
+        if (is_dogleg)
+        {
+            // Only the last solve, the previous ones are not kept
+            json internal_solver = json::array();
+            if (has_factorization)
+            {
+                json info;
+                linear_solver->get_info(info);
+                internal_solver.push_back(info);
+            }
+            solver_info["internal_solver"] = internal_solver;
+            solver_info["time_assembly"] = assembly_time / per_iteration;
+        }
+        solver_info["time_inverting"] = inverting_time / per_iteration;
+    }
+
+    void TrustRegion::reset_times()
+    {
+        assembly_time = 0;
+        inverting_time = 0;
+    }
+
+    void TrustRegion::log_times() const
+    {
+        if (assembly_time <= 0 && inverting_time <= 0)
+            return; // nothing to log
+        m_logger.debug(
+            "[{}][{}] assembly: {:.2e}s; linear_solve: {:.2e}s",
+            fmt::format(fmt::fg(fmt::terminal_color::magenta), "timing"),
+            name(), assembly_time, inverting_time);
+    }
+
+} // namespace polysolve::nonlinear
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "DescentStrategy.hpp"
+#include <polysolve/Utils.hpp>
+
+#include <polysolve/linear/Solver.hpp>
+
+namespace polysolve::nonlinear
+{
+    /// Trust-region globalization: the step minimizes the quadratic model within
+    /// the trust radius and is accepted by the ratio of actual to predicted decrease,
+    /// so the solver does not run a line search after it.
+    class TrustRegion : public DescentStrategy
+    {
+    public:
+        using Superclass = DescentStrategy;
+
+        TrustRegion(const json &solver_params,
+                    const json &linear_solver_params,
+                    const double characteristic_length,
+                    spdlog::logger &logger);
+
+        std::string name() const override { return is_dogleg ? "DoglegTrustRegion" : "SteihaugCGTrustRegion"; }
+
+        /// The problem is left at x + direction, which has already been accepted
+        bool compute_update_direction(
+            Problem &objFunc,
+            const TVector &x,
+            const TVector &grad,
+            TVector &direction) override;
+
+        bool uses_line_search() const override { return false; }
+
+        void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) override;
+
+        void reset(const int ndof) override;
+        void warm_start(const int ndof) override;
+        void save_state(std::ostream &out) const override;
+        void load_state(std::istream &in) override;
+        void update_solver_info(json &solver_info, const double per_iteration) override;
+        void reset_times() override;
+        void log_times() const override;
+
+    private:
+        /// Quadratic model m(p) = gᵀp + ½ pᵀHp of a step
+        struct Step
+        {
+            TVector p;
+            double g_dot_p;
+            double p_H_p;
+
+            double predicted_decrease(const double scale = 1) const { return -scale * (g_dot_p + 0.5 * scale * p_H_p); }
+        };
+
+        /// Truncated CG on Hessian-vector products, stops at the boundary or on negative curvature
+        void solve_steihaug_cg(Problem &objFunc, const TVector &x, const TVector &grad, Step &step) const;
+
+        /// Assembles and factorizes the Hessian, computes the Cauchy and Newton points
+        void prepare_dogleg(Problem &objFunc, const TVector &x, const TVector &grad);
+        /// Combines the Cauchy and Newton points for the current radius
+        void solve_dogleg(const TVector &grad, Step &step) const;
+
+        const bool is_dogleg;
+        double initial_radius;
+        double max_radius;
+        double min_radius;
+        double eta; ///< Minimal ratio of actual to predicted decrease to accept a step
+
+        double radius;
+
+        // Dogleg state
+        std::unique_ptr<polysolve::linear::Solver> linear_solver;
+        polysolve::StiffnessMatrix hessian;
+        TVector cauchy_point;
+        TVector newton_point;
+        bool has_cauchy_point;
+        bool has_newton_point;
+
+        bool has_factorization; ///< linear_solver has been used since the reset, for its info
+        int rejected_steps;
+
+        double assembly_time;
+        double inverting_time;
+    };
+} // namespace polysolve::nonlinear
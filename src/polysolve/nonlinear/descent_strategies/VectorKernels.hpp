@@ -0,0 +1,50 @@
+#pragma once
+
+#include <polysolve/nonlinear/Philox.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cassert>
+
+namespace polysolve::nonlinear
+{
+    /// Rows processed together by the vector kernels of the descent strategies.
+    /// All vectors of a kernel are visited block by block while the block stays in cache,
+    /// so that each vector goes through memory once.
+    constexpr Eigen::Index BLOCK_SIZE = 4096;
+
+    inline Eigen::Index num_blocks(const Eigen::Index n) { return (n + BLOCK_SIZE - 1) / BLOCK_SIZE; }
+
+    /// Calls f(block, start, size) on every row block, in parallel if available
+    template <typename Function>
+    void for_each_block(const Eigen::Index n, const Function &f)
+    {
+        const Eigen::Index blocks = num_blocks(n);
+#ifdef POLYSOLVE_WITH_OPENMP
+#pragma omp parallel for
+#endif
+        for (Eigen::Index b = 0; b < blocks; ++b)
+        {
+            const Eigen::Index start = b * BLOCK_SIZE;
+            f(b, start, std::min(BLOCK_SIZE, n - start));
+        }
+    }
+
+    /// Sets the entries of the segment of a vector starting at start to 0 with
+    /// probability threshold / 2³² and to 1 otherwise. The entry i only depends
+    /// on the generator, the stream and i, not on how the vector is split.
+    /// @param start Multiple of 4, the index of the first entry of mask
+    inline void random_keep_mask(
+        const Philox &rng, const uint64_t stream, const uint64_t threshold,
+        const Eigen::Index start, Eigen::Ref<Eigen::VectorXd> mask)
+    {
+        assert(start % 4 == 0);
+        for (Eigen::Index i = 0; i < mask.size(); i += 4)
+        {
+            const Philox::Counter r = rng((start + i) / 4, stream);
+            for (Eigen::Index k = 0; k < 4 && i + k < mask.size(); ++k)
+                mask[i + k] = r[k] < threshold ? 0 : 1;
+        }
+    }
+} // namespace polysolve::nonlinear
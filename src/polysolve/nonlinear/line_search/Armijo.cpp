@@ -2,6 +2,8 @@
 
 #include "Armijo.hpp"
 
+#include <limits>
+
 namespace polysolve::nonlinear::line_search
 {
     Armijo::Armijo(const json &params, spdlog::logger &logger)
@@ -10,6 +12,22 @@ namespace polysolve::nonlinear::line_search
         c = params["line_search"]["Armijo"]["c"];
     }
 
+    double Armijo::compute_descent_step_size(
+        const TVector &x,
+        const TVector &delta_x,
+        Problem &objFunc,
+        const bool use_grad_norm,
+        const double old_energy,
+        const TVector &old_grad,
+        const double starting_step_size)
+    {
+        // The sufficient decrease condition would accept an increase along an ascent direction
+        if (!(delta_x.dot(old_grad) <= 0))
+            return std::numeric_limits<double>::quiet_NaN();
+
+        return Superclass::compute_descent_step_size(x, delta_x, objFunc, use_grad_norm, old_energy, old_grad, starting_step_size);
+    }
+
     void Armijo::init_compute_descent_step_size(
         const TVector &delta_x,
         const TVector &old_grad)
@@ -26,6 +44,7 @@ namespace polysolve::nonlinear::line_search
         const TVector &old_grad,
         const TVector &new_x,
         const double new_energy,
+        const TVector &new_grad,
         const double step_size) const
     {
         return new_energy <= old_energy + step_size * armijo_criteria;
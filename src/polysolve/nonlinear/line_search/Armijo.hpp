@@ -15,6 +15,16 @@ namespace polysolve::nonlinear::line_search
 
         virtual std::string name() const override { return "Armijo"; }
 
+        /// @brief Fails (NaN) if delta_x is not a descent direction, e.g. an ADAM step
+        double compute_descent_step_size(
+            const TVector &x,
+            const TVector &delta_x,
+            Problem &objFunc,
+            const bool use_grad_norm,
+            const double old_energy,
+            const TVector &old_grad,
+            const double starting_step_size) override;
+
     protected:
         virtual void init_compute_descent_step_size(
             const TVector &delta_x,
@@ -28,6 +38,7 @@ namespace polysolve::nonlinear::line_search
             const TVector &old_grad,
             const TVector &new_x,
             const double new_energy,
+            const TVector &new_grad,
             const double step_size) const override;
 
         double c;
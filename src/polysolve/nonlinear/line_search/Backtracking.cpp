@@ -4,6 +4,9 @@
 
 #include <spdlog/spdlog.h>
 
+#include <limits>
+#include <vector>
+
 namespace polysolve::nonlinear::line_search
 {
 
@@ -21,43 +24,146 @@ namespace polysolve::nonlinear::line_search
         const TVector &old_grad,
         const double starting_step_size)
     {
+        if (batch_size > 1)
+            return compute_descent_step_size_batched(x, delta_x, objFunc, use_grad_norm, old_energy, old_grad, starting_step_size);
+
         double step_size = starting_step_size;
 
         init_compute_descent_step_size(delta_x, old_grad);
 
         for (; step_size > current_min_step_size() && cur_iter < current_max_step_size_iter(); step_size *= step_ratio, ++cur_iter)
         {
-            const TVector new_x = x + step_size * delta_x;
+            if (is_cancelled())
+                return std::numeric_limits<double>::quiet_NaN();
+
+            if (try_step_size(x, delta_x, objFunc, use_grad_norm, old_energy, old_grad, step_size))
+                break; // found a good step size
+        }
+
+        return step_size;
+    }
+
+    bool Backtracking::try_step_size(
+        const TVector &x,
+        const TVector &delta_x,
+        Problem &objFunc,
+        const bool use_grad_norm,
+        const double old_energy,
+        const TVector &old_grad,
+        const double step_size)
+    {
+        const TVector new_x = x + step_size * delta_x;
+
+        if (!update_solution(objFunc, new_x))
+            return false;
+
+        if (!objFunc.is_step_valid(x, new_x))
+            return false;
+
+        double new_energy;
+        TVector new_grad;
+        if (criteria_needs_gradient(use_grad_norm, old_energy, step_size))
+            objFunc.value_and_gradient(new_x, new_energy, new_grad);
+        else
+            new_energy = objFunc(new_x);
+
+        if (!std::isfinite(new_energy))
+            return false;
+
+        m_logger.trace("ls it: {} ΔE: {}", cur_iter, new_energy - old_energy);
+
+        return criteria(delta_x, objFunc, use_grad_norm, old_energy, old_grad, new_x, new_energy, new_grad, step_size);
+    }
+
+    bool Backtracking::update_solution(Problem &objFunc, const TVector &new_x)
+    {
+        try
+        {
+            POLYSOLVE_SCOPED_STOPWATCH("solution changed - constraint set update in LS", constraint_set_update_time, m_logger);
+            objFunc.solution_changed(new_x);
+        }
+        catch (const std::runtime_error &e)
+        {
+            m_logger.warn("Failed to take step due to \"{}\", reduce step size...", e.what());
+            return false;
+        }
+        return true;
+    }
+
+    double Backtracking::compute_descent_step_size_batched(
+        const TVector &x,
+        const TVector &delta_x,
+        Problem &objFunc,
+        const bool use_grad_norm,
+        const double old_energy,
+        const TVector &old_grad,
+        const double starting_step_size)
+    {
+        double step_size = starting_step_size;
+
+        init_compute_descent_step_size(delta_x, old_grad);
+
+        Eigen::VectorXd alphas, energies;
+        Eigen::VectorXi valid;
+        while (step_size > current_min_step_size() && cur_iter < current_max_step_size_iter())
+        {
+            if (is_cancelled())
+                return std::numeric_limits<double>::quiet_NaN();
+
+            // Speculatively evaluate the next step sizes of the serial backtracking
+            std::vector<double> batch;
+            for (double s = step_size; int(batch.size()) < batch_size && s > current_min_step_size()
+                                       && cur_iter + int(batch.size()) < current_max_step_size_iter();
+                 s *= step_ratio)
+                batch.push_back(s);
+            alphas = Eigen::Map<const Eigen::VectorXd>(batch.data(), batch.size());
 
             try
             {
                 POLYSOLVE_SCOPED_STOPWATCH("solution changed - constraint set update in LS", constraint_set_update_time, m_logger);
-                objFunc.solution_changed(new_x);
+                objFunc.value_batch(x, delta_x, alphas, energies, valid);
             }
             catch (const std::runtime_error &e)
             {
-                m_logger.warn("Failed to take step due to \"{}\", reduce step size...", e.what());
-                continue;
-            }
-
-            if (!objFunc.is_step_valid(x, new_x))
-            {
-                continue;
-            }
-
-            const double new_energy = objFunc(new_x);
-
-            if (!std::isfinite(new_energy))
-            {
+                // Do not know which step failed, so retry this batch one step at a time
+                m_logger.warn("Failed to evaluate step batch due to \"{}\", trying steps one at a time...", e.what());
+                for (int i = 0; i < alphas.size(); ++i, ++cur_iter)
+                {
+                    step_size = alphas[i];
+                    if (try_step_size(x, delta_x, objFunc, use_grad_norm, old_energy, old_grad, step_size))
+                        return step_size; // found a good step size
+                }
+                step_size *= step_ratio;
                 continue;
             }
 
-            m_logger.trace("ls it: {} ΔE: {}", cur_iter, new_energy - old_energy);
-
-            if (criteria(delta_x, objFunc, use_grad_norm, old_energy, old_grad, new_x, new_energy, step_size))
+            // Keep the first (largest) acceptable one, as the serial search would
+            for (int i = 0; i < alphas.size(); ++i, ++cur_iter)
             {
-                break; // found a good step size
+                step_size = alphas[i];
+                if (!valid[i] || !std::isfinite(energies[i]))
+                    continue;
+
+                const TVector new_x = x + step_size * delta_x;
+
+                // value_batch already updated the problem at every step, so only move it to new_x
+                // again when the criteria needs the gradient there or the step is accepted
+                TVector new_grad;
+                const bool needs_gradient = criteria_needs_gradient(use_grad_norm, old_energy, step_size);
+                if (needs_gradient)
+                {
+                    if (!update_solution(objFunc, new_x))
+                        continue;
+                    objFunc.gradient(new_x, new_grad);
+                }
+
+                m_logger.trace("ls it: {} ΔE: {}", cur_iter, energies[i] - old_energy);
+
+                if (criteria(delta_x, objFunc, use_grad_norm, old_energy, old_grad, new_x, energies[i], new_grad, step_size)
+                    && (needs_gradient || update_solution(objFunc, new_x)))
+                    return step_size; // found a good step size
             }
+            step_size *= step_ratio;
         }
 
         return step_size;
@@ -71,12 +177,17 @@ namespace polysolve::nonlinear::line_search
         const TVector &old_grad,
         const TVector &new_x,
         const double new_energy,
+        const TVector &new_grad,
         const double step_size) const
     {
         if (use_grad_norm)
         {
-            TVector new_grad;
-            objFunc.gradient(new_x, new_grad);
+            if (new_grad.size() == 0)
+            {
+                TVector grad;
+                objFunc.gradient(new_x, grad);
+                return grad.norm() < old_grad.norm();
+            }
             return new_grad.norm() < old_grad.norm(); // TODO: cache old_grad.norm()
         }
         return new_energy < old_energy;
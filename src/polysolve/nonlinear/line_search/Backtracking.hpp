@@ -25,10 +25,46 @@ namespace polysolve::nonlinear::line_search
             const double starting_step_size) override;
 
     protected:
+        /// @brief Same as compute_descent_step_size, but evaluates batch_size step sizes at once
+        /// with Problem::value_batch and keeps the largest acceptable one
+        double compute_descent_step_size_batched(
+            const TVector &x,
+            const TVector &delta_x,
+            Problem &objFunc,
+            const bool use_grad_norm,
+            const double old_energy,
+            const TVector &old_grad,
+            const double starting_step_size);
+
+        /// @brief Evaluates a single step size of the serial search
+        /// @return True if the step size is accepted, in which case the problem is left at x + step_size * delta_x
+        bool try_step_size(
+            const TVector &x,
+            const TVector &delta_x,
+            Problem &objFunc,
+            const bool use_grad_norm,
+            const double old_energy,
+            const TVector &old_grad,
+            const double step_size);
+
+        /// @brief Calls objFunc.solution_changed(new_x)
+        /// @return False if the problem rejected new_x by throwing a std::runtime_error
+        bool update_solution(Problem &objFunc, const TVector &new_x);
+
         virtual void init_compute_descent_step_size(
             const TVector &delta_x,
             const TVector &old_grad) {}
 
+        /// @brief If the criteria at this step size needs the gradient at the new point,
+        /// in which case it is evaluated together with the energy
+        virtual bool criteria_needs_gradient(
+            const bool use_grad_norm,
+            const double old_energy,
+            const double step_size) const { return use_grad_norm; }
+
+        /// @param new_grad Gradient at new_x, empty if it was not evaluated.
+        /// When it is empty, the problem may not be at new_x (batched search) and must be moved there
+        /// with solution_changed before evaluating anything at new_x.
         virtual bool criteria(
             const TVector &delta_x,
             Problem &objFunc,
@@ -37,6 +73,7 @@ namespace polysolve::nonlinear::line_search
             const TVector &old_grad,
             const TVector &new_x,
             const double new_energy,
+            const TVector &new_grad,
             const double step_size) const;
     };
 } // namespace polysolve::nonlinear::line_search
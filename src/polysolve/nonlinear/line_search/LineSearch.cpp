@@ -63,6 +63,9 @@ namespace polysolve::nonlinear::line_search
 
         default_init_step_size = params["line_search"]["default_init_step_size"];
         step_ratio = params["line_search"]["step_ratio"];
+        batch_size = params["line_search"]["batch_size"];
+        if (batch_size < 1)
+            log_and_throw_error(logger, "Line search batch_size must be ≥ 1, instead got {}", batch_size);
     }
 
     double LineSearch::line_search(
@@ -80,14 +83,13 @@ namespace polysolve::nonlinear::line_search
 
             cur_iter = 0;
 
-            initial_energy = objFunc(x);
+            objFunc.value_and_gradient(x, initial_energy, initial_grad);
             if (std::isnan(initial_energy))
             {
                 m_logger.error("Original energy in line search is nan!");
                 return NaN;
             }
 
-            objFunc.gradient(x, initial_grad);
             if (!initial_grad.array().isFinite().all())
             {
                 m_logger.error("Original gradient in line search is nan!");
@@ -146,6 +148,11 @@ namespace polysolve::nonlinear::line_search
             if (std::isnan(step_size))
             {
                 // Superclass::save_sampled_values("failed-line-search-values.csv", x, delta_x, objFunc);
+                if (is_cancelled())
+                {
+                    objFunc.solution_changed(x);
+                    objFunc.line_search_end();
+                }
                 return NaN;
             }
         }
@@ -194,6 +201,9 @@ namespace polysolve::nonlinear::line_search
         // Find step that does not result in nan or infinite energy
         while (step_size > current_min_step_size() && cur_iter < current_max_step_size_iter())
         {
+            if (is_cancelled())
+                return NaN;
+
             if (!objFunc.is_step_valid(x, new_x) || !std::isfinite(objFunc(new_x)))
             {
                 step_size *= rate;
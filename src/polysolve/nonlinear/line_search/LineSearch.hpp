@@ -1,7 +1,10 @@
 #pragma once
 
+#include <polysolve/Cancellation.hpp>
 #include <polysolve/nonlinear/Problem.hpp>
 
+#include <iosfwd>
+
 namespace spdlog
 {
     class logger;
@@ -50,6 +53,11 @@ namespace polysolve::nonlinear::line_search
         void reset_times();
         void log_times() const;
 
+        /// @brief Write the state kept between line searches to a checkpoint, none by default
+        virtual void save_state(std::ostream &out) const {}
+        /// @brief Restore the state written by save_state
+        virtual void load_state(std::istream &in) {}
+
         void set_is_final_strategy(const bool val)
         {
             is_final_strategy = val;
@@ -67,6 +75,10 @@ namespace polysolve::nonlinear::line_search
 
         int iterations() const { return cur_iter; }
 
+        /// @brief Token checked before each trial step, the line search fails (NaN) once it is
+        /// cancelled and leaves the problem at x
+        void set_cancellation_token(const std::shared_ptr<const CancellationToken> &token) { m_cancellation = token; }
+
         double checking_for_nan_inf_time;
         double broad_phase_ccd_time;
         double narrow_phase_ccd_time;
@@ -94,9 +106,12 @@ namespace polysolve::nonlinear::line_search
             const TVector &old_grad,
             const double starting_step_size) = 0;
 
+        bool is_cancelled() const { return m_cancellation && m_cancellation->is_cancelled(); }
+
         spdlog::logger &m_logger;
         double step_ratio;
         int cur_iter;
+        int batch_size; ///< Number of step sizes evaluated together by Problem::value_batch
 
     private:
         /// @brief Compute step size that avoids nan/infinite energy
@@ -132,5 +147,7 @@ namespace polysolve::nonlinear::line_search
         bool is_final_strategy;
 
         double default_init_step_size;
+
+        std::shared_ptr<const CancellationToken> m_cancellation;
     };
 } // namespace polysolve::nonlinear::line_search
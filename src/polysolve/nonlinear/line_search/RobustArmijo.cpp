@@ -13,6 +13,16 @@ namespace polysolve::nonlinear::line_search
             "/line_search/RobustArmijo/delta_relative_tolerance"_json_pointer);
     }
 
+    bool RobustArmijo::criteria_needs_gradient(
+        const bool use_grad_norm,
+        const double old_energy,
+        const double step_size) const
+    {
+        // The gradient is needed if the energy difference is expected to be below the tolerance,
+        // predicted to first order as α |Δx⋅∇f| = α |armijo_criteria| / c
+        return use_grad_norm || step_size * std::abs(this->armijo_criteria) <= this->c * delta_relative_tolerance * std::abs(old_energy);
+    }
+
     bool RobustArmijo::criteria(
         const TVector &delta_x,
         Problem &objFunc,
@@ -21,6 +31,7 @@ namespace polysolve::nonlinear::line_search
         const TVector &old_grad,
         const TVector &new_x,
         const double new_energy,
+        const TVector &new_grad,
         const double step_size) const
     {
         if (new_energy <= old_energy + step_size * this->armijo_criteria) // Try Armijo first
@@ -28,11 +39,17 @@ namespace polysolve::nonlinear::line_search
 
         if (std::abs(new_energy - old_energy) <= delta_relative_tolerance * std::abs(old_energy))
         {
-            TVector new_grad;
-            objFunc.gradient(new_x, new_grad);
-
-            const double deltaE_approx = step_size / 2 * delta_x.dot(new_grad + old_grad);
-            const double abs_eps_est = step_size / 2 * std::abs(delta_x.dot(new_grad - old_grad));
+            TVector evaluated_grad;
+            if (new_grad.size() == 0)
+            {
+                // The problem is not necessarily at new_x (see compute_descent_step_size_batched)
+                objFunc.solution_changed(new_x);
+                objFunc.gradient(new_x, evaluated_grad);
+            }
+            const TVector &grad = new_grad.size() == 0 ? evaluated_grad : new_grad;
+
+            const double deltaE_approx = step_size / 2 * delta_x.dot(grad + old_grad);
+            const double abs_eps_est = step_size / 2 * std::abs(delta_x.dot(grad - old_grad));
 
             if (deltaE_approx + abs_eps_est <= step_size * this->armijo_criteria)
                 return true;
@@ -17,6 +17,11 @@ namespace polysolve::nonlinear::line_search
         virtual std::string name() const override { return "RobustArmijo"; }
 
     protected:
+        bool criteria_needs_gradient(
+            const bool use_grad_norm,
+            const double old_energy,
+            const double step_size) const override;
+
         bool criteria(
             const TVector &delta_x,
             Problem &objFunc,
@@ -25,6 +30,7 @@ namespace polysolve::nonlinear::line_search
             const TVector &old_grad,
             const TVector &new_x,
             const double new_energy,
+            const TVector &new_grad,
             const double step_size) const override;
 
         double delta_relative_tolerance;
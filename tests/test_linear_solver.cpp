@@ -3,6 +3,7 @@
 #include <polysolve/linear/FEMSolver.hpp>
 
 #include <polysolve/Utils.hpp>
+#include <polysolve/BinaryIO.hpp>
 
 #ifdef POLYSOLVE_WITH_AMGCL
 #include <polysolve/linear/AMGCL.hpp>
@@ -16,7 +17,10 @@
 #include <fstream>
 #include <vector>
 #include <ctime>
+#include <cstring>
+#include <functional>
 #include <chrono>
+#include <filesystem>
 //////////////////////////////////////////////////////////////////////////
 
 using namespace polysolve;
@@ -156,6 +160,240 @@ TEST_CASE("all", "[solver]")
     }
 }
 
+TEST_CASE("dense_inplace", "[solver]")
+{
+    const int n = 50;
+    Eigen::MatrixXd M = Eigen::MatrixXd::Random(n, n);
+    const Eigen::MatrixXd A = M * M.transpose() + n * Eigen::MatrixXd::Identity(n, n);
+    const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+    std::vector<std::string> solvers = {"Eigen::LLT", "Eigen::LDLT", "Eigen::PartialPivLU"};
+#ifdef POLYSOLVE_WITH_LAPACK
+    solvers.insert(solvers.end(), {"LAPACK::LLT", "LAPACK::LDLT", "LAPACK::LU"});
+#endif
+
+    for (const auto &s : solvers)
+    {
+        auto solver = Solver::create(s, "");
+        REQUIRE(solver->is_dense());
+
+        Eigen::MatrixXd storage = A;
+        solver->analyze_pattern_dense(storage, n);
+        solver->factorize_dense_inplace(storage);
+
+        Eigen::VectorXd x(n);
+        x.setZero();
+        solver->solve(b, x);
+
+        INFO("solver: " + s);
+        REQUIRE((A * x - b).norm() < 1e-8);
+        if (solver->factorize_dense_preserves_upper())
+        {
+            const Eigen::MatrixXd upper = storage.triangularView<Eigen::StrictlyUpper>();
+            REQUIRE(upper == Eigen::MatrixXd(A.triangularView<Eigen::StrictlyUpper>()));
+        }
+    }
+}
+
+TEST_CASE("cancellation", "[solver]")
+{
+    // 1D Laplacian, slow to converge with CG
+    const int n = 500;
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < n; ++i)
+    {
+        triplets.emplace_back(i, i, 2);
+        if (i + 1 < n)
+        {
+            triplets.emplace_back(i, i + 1, -1);
+            triplets.emplace_back(i + 1, i, -1);
+        }
+    }
+    StiffnessMatrix A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    const Eigen::VectorXd b = Eigen::VectorXd::Ones(n);
+
+    const std::string s = "Eigen::ConjugateGradient";
+    auto solver = Solver::create(s, "");
+    json params;
+    params[s]["tolerance"] = 1e-12;
+    params[s]["max_iter"] = 10 * n;
+    solver->set_parameters(params);
+    solver->analyze_pattern(A, n);
+    solver->factorize(A);
+
+    auto token = std::make_shared<CancellationToken>();
+    solver->set_cancellation_token(token);
+
+    // Solved in chunks to the same tolerance
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+    solver->solve(b, x);
+    json info;
+    solver->get_info(info);
+    CHECK(info["solver_iter"].get<int>() > 64);
+    CHECK((A * x - b).norm() < 1e-8 * b.norm());
+
+    // Stops after the first chunk once cancelled
+    token->cancel();
+    x.setZero();
+    solver->solve(b, x);
+    solver->get_info(info);
+    CHECK(info["solver_iter"].get<int>() <= 64);
+    CHECK((A * x - b).norm() > 1e-8 * b.norm());
+}
+
+TEST_CASE("binary_io", "[solver]")
+{
+    const int n = 200;
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < n; ++i)
+    {
+        triplets.emplace_back(i, i, 4);
+        triplets.emplace_back((i * 7) % n, i, -1);
+        triplets.emplace_back(i, (i * 13 + 5) % n, 0.5 * i);
+    }
+    StiffnessMatrix A(n, n + 3);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    A.makeCompressed();
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path();
+    const std::string raw_path = (dir / "polysolve_binary_io.bin").string();
+    const std::string compressed_path = (dir / "polysolve_binary_io_compressed.bin").string();
+    const std::string mtx_path = (dir / "polysolve_binary_io.mtx").string();
+    const std::string vec_path = (dir / "polysolve_binary_io_vec.bin").string();
+
+    write_binary(raw_path, A);
+    write_binary(compressed_path, A, true);
+    REQUIRE(std::filesystem::file_size(compressed_path) < std::filesystem::file_size(raw_path));
+
+    for (const auto &path : {raw_path, compressed_path})
+    {
+        StiffnessMatrix B;
+        REQUIRE(read_binary(path, B));
+        REQUIRE(B.rows() == A.rows());
+        REQUIRE(B.cols() == A.cols());
+        REQUIRE((Eigen::MatrixXd(A) - Eigen::MatrixXd(B)).norm() == 0);
+    }
+
+    {
+        MappedBinaryMatrix mapped(raw_path);
+        const Eigen::Map<StiffnessMatrix> B = mapped.matrix();
+        REQUIRE(B.nonZeros() == A.nonZeros());
+        REQUIRE((Eigen::MatrixXd(A) - Eigen::MatrixXd(B)).norm() == 0);
+    }
+    REQUIRE_THROWS(MappedBinaryMatrix(compressed_path));
+
+    Eigen::saveMarket(A, mtx_path);
+    REQUIRE(convert_market_to_binary(mtx_path, raw_path));
+    StiffnessMatrix C;
+    REQUIRE(read_binary(raw_path, C));
+    REQUIRE((Eigen::MatrixXd(A) - Eigen::MatrixXd(C)).norm() == 0);
+
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(n);
+    Eigen::VectorXd w;
+    write_binary(vec_path, v);
+    REQUIRE(read_binary(vec_path, w));
+    REQUIRE(v == w);
+    REQUIRE(!read_binary(vec_path, C));
+
+    // Truncated or corrupted files are rejected instead of read out of bounds
+    write_binary(raw_path, A);
+    write_binary(compressed_path, A, true);
+    const auto corrupt = [&](const std::string &src, const std::function<void(std::string &)> &f) {
+        std::ifstream in(src, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        f(bytes);
+        std::ofstream(mtx_path, std::ios::binary).write(bytes.data(), bytes.size());
+        StiffnessMatrix D;
+        CHECK(!read_binary(mtx_path, D));
+        if (src == raw_path)
+            CHECK_THROWS(MappedBinaryMatrix(mtx_path));
+    };
+    typedef StiffnessMatrix::StorageIndex StorageIndex;
+    const size_t outer_offset = sizeof(BinaryHeader);
+    const size_t inner_offset = outer_offset + ((A.outerSize() + 1) * sizeof(StorageIndex) + 7) / 8 * 8;
+    const auto set_index = [](std::string &bytes, const size_t offset, const StorageIndex value) {
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+    };
+    for (const auto &path : {raw_path, compressed_path})
+    {
+        corrupt(path, [](std::string &bytes) { bytes.resize(bytes.size() - 16); });
+        corrupt(path, [](std::string &bytes) { bytes.resize(sizeof(BinaryHeader) + 8); });
+        corrupt(path, [](std::string &bytes) { reinterpret_cast<BinaryHeader *>(&bytes[0])->outer_bytes = 4; });
+        corrupt(path, [](std::string &bytes) { reinterpret_cast<BinaryHeader *>(&bytes[0])->nnz += 1000; });
+    }
+    corrupt(raw_path, [&](std::string &bytes) { set_index(bytes, inner_offset, StorageIndex(A.rows())); });
+    corrupt(raw_path, [&](std::string &bytes) { set_index(bytes, inner_offset, -1); });
+    corrupt(raw_path, [&](std::string &bytes) { set_index(bytes, outer_offset + 2 * sizeof(StorageIndex), 0); });
+    corrupt(raw_path, [&](std::string &bytes) { set_index(bytes, outer_offset, 1); });
+
+    for (const auto &path : {raw_path, compressed_path, mtx_path, vec_path})
+        std::filesystem::remove(path);
+}
+
+TEST_CASE("memory_limit", "[solver]")
+{
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_memory");
+    logger->set_level(spdlog::level::err);
+
+    // 2D Laplacian
+    const int m = 30, n = m * m;
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < m; ++j)
+        {
+            const int k = i * m + j;
+            triplets.emplace_back(k, k, 4.1);
+            if (i > 0)
+                triplets.emplace_back(k, k - m, -1);
+            if (i < m - 1)
+                triplets.emplace_back(k, k + m, -1);
+            if (j > 0)
+                triplets.emplace_back(k, k - 1, -1);
+            if (j < m - 1)
+                triplets.emplace_back(k, k + 1, -1);
+        }
+    }
+    StiffnessMatrix A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    const Eigen::VectorXd b = Eigen::VectorXd::Random(n);
+
+    for (const double limit : {0., 100., 1e-3})
+    {
+        json params;
+        params["solver"] = "Eigen::SimplicialLDLT";
+        params["memory_limit"] = limit;
+        params["memory_limit_fallback"] = "Eigen::ConjugateGradient";
+        params["Eigen::ConjugateGradient"]["tolerance"] = 1e-12;
+        auto solver = Solver::create(params, *logger);
+
+        Eigen::VectorXd x(n);
+        x.setZero();
+        solver->analyze_pattern(A, n);
+        const int64_t estimate = solver->estimated_factor_bytes();
+        solver->factorize(A);
+        solver->solve(b, x);
+
+        json info;
+        solver->get_info(info);
+        INFO("limit: " << limit);
+        REQUIRE((A * x - b).norm() < 1e-8);
+        if (limit == 1e-3)
+        {
+            REQUIRE(info["memory_fallback"].get<bool>());
+            REQUIRE(solver->name() == "Eigen::ConjugateGradient");
+        }
+        else
+        {
+            REQUIRE(solver->name() == "Eigen::SimplicialLDLT");
+            REQUIRE(estimate > 0);
+            // the symbolic estimate matches the actual factors
+            REQUIRE(info["factor_bytes"].get<int64_t>() == estimate);
+        }
+    }
+}
+
 TEST_CASE("eigen_params", "[solver]")
 {
     const std::string path = POLYFEM_DATA_DIR;
@@ -184,7 +422,10 @@ TEST_CASE("eigen_params", "[solver]")
             solver->factorize(A);
             solver->solve(b, x);
 
-            // solver->get_info(solver_info);
+            json solver_info;
+            solver->get_info(solver_info);
+            CHECK(solver->iterations() > 0);
+            CHECK(solver->iterations() == solver_info["solver_iter"].get<int>());
 
             // std::cout<<"Solver error: "<<x<<std::endl;
             const double err = (A * x - b).norm();
@@ -1,8 +1,14 @@
 //////////////////////////////////////////////////////////////////////////
 #include "autodiff.h"
 #include <polysolve/nonlinear/Solver.hpp>
+#include <polysolve/nonlinear/BatchedSolver.hpp>
 #include <polysolve/nonlinear/BoxConstraintSolver.hpp>
+#include <polysolve/nonlinear/FixedSolver.hpp>
+#include <polysolve/nonlinear/MultiStartSolver.hpp>
+#include <polysolve/nonlinear/StochasticSolver.hpp>
 #include <polysolve/nonlinear/Problem.hpp>
+#include <polysolve/PerfCounters.hpp>
+#include <polysolve/Tracing.hpp>
 #include <polysolve/Utils.hpp>
 #include <polysolve/Types.hpp>
 #include <polysolve/linear/Solver.hpp>
@@ -11,6 +17,12 @@
 #include <polysolve/JSONUtils.hpp>
 #include <catch2/catch.hpp>
 
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
 //////////////////////////////////////////////////////////////////////////
 
 using namespace polysolve;
@@ -481,6 +493,1537 @@ TEST_CASE("nonlinear-fallbacks", "[solver]")
     }
 }
 
+TEST_CASE("nonlinear-inexact-newton", "[solver]")
+{
+    std::vector<std::unique_ptr<TestProblem>> problems;
+    problems.push_back(std::make_unique<QuadraticProblem>());
+    problems.push_back(std::make_unique<Rosenbrock>());
+    problems.push_back(std::make_unique<Sphere>());
+
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["max_iterations"] = 1000;
+    solver_params["advanced"]["telemetry_size"] = 1000;
+    linear_solver_params["solver"] = "Eigen::ConjugateGradient";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_inexact");
+    logger->set_level(spdlog::level::info);
+    TestProblem::TVector g;
+
+    std::map<std::string, int> linear_iterations;
+    for (const std::string forcing_term : {"None", "EisenstatWalker1", "EisenstatWalker2"})
+    {
+        solver_params["Newton"]["forcing_term"] = forcing_term;
+        // Same starting points for every forcing term
+        std::srand(0);
+        for (auto &prob : problems)
+        {
+            TestProblem::TVector x(prob->size());
+            for (int i = 0; i < N_RANDOM; ++i)
+            {
+                x.setRandom();
+                x /= 10;
+                x += prob->solutions()[0];
+
+                auto solver = Solver::create(solver_params,
+                                             linear_solver_params,
+                                             characteristic_length,
+                                             *logger);
+                solver->minimize(*prob, x);
+
+                double err = std::numeric_limits<double>::max();
+                for (auto sol : prob->solutions())
+                    err = std::min(err, (x - sol).norm());
+                if (err >= 1e-7)
+                {
+                    prob->gradient(x, g);
+                    err = g.norm();
+                }
+                INFO("forcing term: " + forcing_term + " problem " + prob->name());
+                CHECK(err < 1e-7);
+
+                const Telemetry &telemetry = solver->telemetry();
+                REQUIRE(telemetry.size() == telemetry.total());
+                for (size_t k = 0; k < telemetry.size(); ++k)
+                    linear_iterations[forcing_term] += std::max(telemetry[k].linear_iterations, 0);
+            }
+        }
+    }
+
+    // The early iterations are solved loosely
+    CHECK(linear_iterations["EisenstatWalker1"] < linear_iterations["None"]);
+    CHECK(linear_iterations["EisenstatWalker2"] < linear_iterations["None"]);
+}
+
+TEST_CASE("nonlinear-lbfgs-history", "[solver]")
+{
+    std::vector<std::unique_ptr<TestProblem>> problems;
+    problems.push_back(std::make_unique<QuadraticProblem>());
+    problems.push_back(std::make_unique<Rosenbrock>());
+    problems.push_back(std::make_unique<Sphere>());
+
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "L-BFGS";
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_lbfgs");
+    logger->set_level(spdlog::level::err);
+    TestProblem::TVector g;
+
+    for (const std::string precision : {"double", "float"})
+    {
+        // Small history to also exercise its wrap around
+        solver_params["L-BFGS"]["history_size"] = 3;
+        solver_params["L-BFGS"]["history_precision"] = precision;
+        for (auto &prob : problems)
+        {
+            TestProblem::TVector x(prob->size());
+            x.setRandom();
+            x /= 10;
+            x += prob->solutions()[0];
+
+            auto solver = Solver::create(solver_params,
+                                         linear_solver_params,
+                                         characteristic_length,
+                                         *logger);
+            solver->minimize(*prob, x);
+
+            double err = std::numeric_limits<double>::max();
+            for (auto sol : prob->solutions())
+                err = std::min(err, (x - sol).norm());
+            if (err >= 1e-7)
+            {
+                prob->gradient(x, g);
+                err = g.norm();
+            }
+            INFO("precision: " + precision + " problem " + prob->name());
+            CHECK(err < 1e-7);
+        }
+    }
+}
+
+TEST_CASE("nonlinear-bfgs-update", "[solver]")
+{
+    std::vector<std::unique_ptr<TestProblem>> problems;
+    problems.push_back(std::make_unique<QuadraticProblem>());
+    problems.push_back(std::make_unique<Rosenbrock>());
+    problems.push_back(std::make_unique<Sphere>());
+
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "BFGS";
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::LDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_bfgs");
+    logger->set_level(spdlog::level::err);
+    TestProblem::TVector g;
+
+    for (const std::string update : {"InverseHessian", "Hessian"})
+    {
+        solver_params["BFGS"]["update"] = update;
+        for (auto &prob : problems)
+        {
+            TestProblem::TVector x(prob->size());
+            x.setRandom();
+            x /= 10;
+            x += prob->solutions()[0];
+
+            auto solver = Solver::create(solver_params,
+                                         linear_solver_params,
+                                         characteristic_length,
+                                         *logger);
+            solver->minimize(*prob, x);
+
+            double err = std::numeric_limits<double>::max();
+            for (auto sol : prob->solutions())
+                err = std::min(err, (x - sol).norm());
+            if (err >= 1e-7)
+            {
+                prob->gradient(x, g);
+                err = g.norm();
+            }
+            INFO("update: " + update + " problem " + prob->name());
+            CHECK(err < 1e-7);
+        }
+    }
+}
+
+TEST_CASE("stochastic-seed", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["max_iterations"] = 20;
+    solver_params["allow_out_of_iterations"] = true;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_seed");
+    logger->set_level(spdlog::level::err);
+
+    for (const std::string solver_name : {"StochasticGradientDescent", "StochasticADAM"})
+    {
+        solver_params["solver"] = solver_name;
+        // ADAM directions are not descent directions, its steps are bounded by alpha
+        solver_params["line_search"]["method"] = solver_name == "StochasticADAM" ? "None" : "Backtracking";
+
+        std::vector<TestProblem::TVector> xs;
+        for (const int seed : {1, 1, 2})
+        {
+            solver_params[solver_name]["seed"] = seed;
+
+            Rosenbrock prob;
+            TestProblem::TVector x = TestProblem::TVector::Zero(prob.size());
+
+            auto solver = Solver::create(solver_params,
+                                         linear_solver_params,
+                                         characteristic_length,
+                                         *logger);
+            solver->minimize(prob, x);
+            xs.push_back(x);
+        }
+
+        INFO("solver: " + solver_name);
+        // The erased components only depend on the seed
+        CHECK((xs[0] - xs[1]).norm() == 0);
+        CHECK((xs[0] - xs[2]).norm() > 0);
+    }
+}
+
+// Noisy least squares f(x) = 1/N Σᵢ ½(aᵢᵀx - bᵢ)², the terms do not vanish at the minimum
+class LeastSquares : public StochasticProblem
+{
+public:
+    LeastSquares()
+    {
+        const int n_terms = 200, n_dofs = 5;
+        A.resize(n_terms, n_dofs);
+        b.resize(n_terms);
+        for (int i = 0; i < n_terms; ++i)
+        {
+            for (int j = 0; j < n_dofs; ++j)
+                A(i, j) = std::sin(1.3 * i + 2.7 * j + 0.5);
+            b[i] = A.row(i).sum() + 0.1 * std::cos(7.1 * i);
+        }
+    }
+
+    int num_terms() const override { return A.rows(); }
+
+    double value(const TVector &x) override { return 0.5 * (A * x - b).squaredNorm() / A.rows(); }
+
+    void gradient_batch(const TVector &x, const Eigen::Ref<const Eigen::VectorXi> &indices, TVector &grad) override
+    {
+        grad.setZero(x.size());
+        for (int k = 0; k < indices.size(); ++k)
+        {
+            const int i = indices[k];
+            grad += A.row(i).transpose() * ((A.row(i).dot(x) - b[i]) / A.rows());
+        }
+    }
+
+    void hessian(const TVector &x, THessian &hessian) override
+    {
+        hessian = (A.transpose() * A / A.rows()).sparseView();
+    }
+
+    Eigen::MatrixXd A;
+    Eigen::VectorXd b;
+};
+
+TEST_CASE("stochastic-minibatch", "[solver]")
+{
+    json solver_params;
+    solver_params["max_iterations"] = 2000;
+    solver_params["grad_norm"] = 1e-6;
+    solver_params["allow_out_of_iterations"] = true;
+    solver_params["stochastic"]["batch_size"] = 10;
+    solver_params["stochastic"]["learning_rate"] = 1;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_minibatch");
+    logger->set_level(spdlog::level::err);
+
+    for (const std::string solver_name : {"GradientDescent", "ADAM"})
+    {
+        solver_params["solver"] = solver_name;
+
+        std::vector<TestProblem::TVector> xs;
+        for (const std::string variance_reduction : {"None", "SVRG", "SVRG"})
+        {
+            solver_params["stochastic"]["variance_reduction"] = variance_reduction;
+
+            LeastSquares prob;
+            TestProblem::TVector x = TestProblem::TVector::Zero(prob.A.cols());
+
+            auto solver = StochasticSolver::create(solver_params, characteristic_length, *logger);
+            solver->minimize(prob, x);
+            xs.push_back(x);
+
+            INFO("solver: " + solver_name + " variance reduction: " + variance_reduction);
+            // Without variance reduction the batch gradients do not vanish at the minimum
+            CHECK(solver->status() == (variance_reduction == "SVRG" ? Status::GradNormTolerance : Status::IterationLimit));
+            CHECK(solver->info()["epochs"].get<int>() > 1);
+        }
+
+        // The batches only depend on the seed
+        CHECK((xs[1] - xs[2]).norm() == 0);
+    }
+}
+
+// Stops through the callback after a fixed number of iterations
+class StoppingLeastSquares : public LeastSquares
+{
+public:
+    bool callback(const Criteria &state, const TVector &x) override { return state.iterations + 1 < stop_iterations; }
+
+    int stop_iterations = 5;
+};
+
+class EmptyLeastSquares : public LeastSquares
+{
+public:
+    int num_terms() const override { return 0; }
+};
+
+TEST_CASE("stochastic-stop", "[solver]")
+{
+    json solver_params;
+    solver_params["solver"] = "GradientDescent";
+    solver_params["max_iterations"] = 100;
+    solver_params["allow_out_of_iterations"] = false;
+    solver_params["stochastic"]["batch_size"] = 10;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_stochastic_stop");
+    logger->set_level(spdlog::level::off);
+
+    auto solver = StochasticSolver::create(solver_params, characteristic_length, *logger);
+
+    SECTION("callback")
+    {
+        StoppingLeastSquares prob;
+        TestProblem::TVector x = TestProblem::TVector::Zero(prob.A.cols());
+
+        // Stopping from the callback is not an iteration limit
+        CHECK_NOTHROW(solver->minimize(prob, x));
+        CHECK(solver->status() == Status::Continue);
+        CHECK(solver->info()["iterations"].get<int>() == prob.stop_iterations);
+    }
+
+    SECTION("empty")
+    {
+        EmptyLeastSquares prob;
+        TestProblem::TVector x = TestProblem::TVector::Zero(prob.A.cols());
+
+        CHECK_THROWS(solver->minimize(prob, x));
+    }
+}
+
+TEST_CASE("multi-start", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_multi_start");
+    logger->set_level(spdlog::level::err);
+
+    const auto factory = [](const int start) { return std::make_unique<Rosenbrock>(); };
+
+    SECTION("parallel")
+    {
+        solver_params["multi_start"]["num_threads"] = 4;
+
+        std::vector<TestProblem::TVector> x0s;
+        for (int i = 0; i < 8; ++i)
+            x0s.push_back(TestProblem::TVector::Constant(10, -2 + 0.5 * i));
+
+        auto solver = MultiStartSolver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        const auto results = solver->minimize(factory, x0s);
+
+        REQUIRE(results.size() == x0s.size());
+        std::vector<bool> seen(x0s.size(), false);
+        for (int i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            INFO("start " << r.start);
+            CHECK(r.error.empty());
+            CHECK(!r.pruned);
+            CHECK(r.status == Status::GradNormTolerance);
+            CHECK(r.energy == r.info["energy"].get<double>());
+            if (i > 0)
+                CHECK(results[i - 1].energy <= r.energy);
+            seen[r.start] = true;
+        }
+        CHECK(std::all_of(seen.begin(), seen.end(), [](bool b) { return b; }));
+        CHECK(results[0].energy < 1e-10);
+    }
+
+    SECTION("pruning")
+    {
+        // With a single thread the runs are in order: the first one converges
+        // immediately and the second one is dominated after its first iteration
+        solver_params["multi_start"]["num_threads"] = 1;
+        solver_params["multi_start"]["prune_after_iterations"] = 1;
+        solver_params["multi_start"]["prune_tolerance"] = 0;
+
+        std::vector<TestProblem::TVector> x0s = {TestProblem::TVector::Ones(10), TestProblem::TVector::Constant(10, -2)};
+
+        auto solver = MultiStartSolver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        const auto results = solver->minimize(factory, x0s);
+
+        REQUIRE(results.size() == 2);
+        CHECK(results[0].start == 0);
+        CHECK(!results[0].pruned);
+        CHECK(results[1].start == 1);
+        CHECK(results[1].pruned);
+        CHECK(results[1].status == Status::ObjectiveCustomStop);
+        CHECK(results[1].info["iterations"].get<int>() <= 2);
+    }
+}
+
+// 2D Rosenbrock (aₚ - x)² + 100 (y - x²)² with a different minimum (aₚ, aₚ²) on each lane
+class BatchedRosenbrock : public BatchedProblem
+{
+public:
+    BatchedRosenbrock(const int n_problems) : a(TVector::LinSpaced(n_problems, 0.5, 1.5)) {}
+
+    int num_problems() const override { return a.size(); }
+    int num_dofs() const override { return 2; }
+
+    void value(const TMatrix &X, TVector &f) override
+    {
+        const auto x = X.col(0).array(), y = X.col(1).array();
+        f = ((a.array() - x).square() + 100 * (y - x.square()).square()).matrix();
+    }
+
+    void value_and_gradient(const TMatrix &X, TVector &f, TMatrix &grad) override
+    {
+        value(X, f);
+        const auto x = X.col(0).array(), y = X.col(1).array();
+        grad.resize(X.rows(), 2);
+        grad.col(0) = (-2 * (a.array() - x) - 400 * x * (y - x.square())).matrix();
+        grad.col(1) = (200 * (y - x.square())).matrix();
+    }
+
+    void hessian(const TMatrix &X, TMatrix &hessian) override
+    {
+        const auto x = X.col(0).array(), y = X.col(1).array();
+        hessian.resize(X.rows(), 4);
+        hessian.col(0) = (2 - 400 * y + 1200 * x.square()).matrix();
+        hessian.col(1) = (-400 * x).matrix();
+        hessian.col(2) = hessian.col(1);
+        hessian.col(3).setConstant(200);
+    }
+
+    TVector a;
+};
+
+TEST_CASE("batched", "[solver]")
+{
+    json solver_params;
+    solver_params["max_iterations"] = 500;
+    solver_params["grad_norm"] = 1e-8;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_batched");
+    logger->set_level(spdlog::level::err);
+
+    for (const std::string solver_name : BatchedSolver::available_solvers())
+    {
+        solver_params["solver"] = solver_name;
+
+        BatchedRosenbrock prob(1000);
+        Eigen::MatrixXd X(prob.num_problems(), prob.num_dofs());
+        X.col(0).setConstant(-1.2);
+        X.col(1).setConstant(1);
+
+        auto solver = BatchedSolver::create(solver_params, characteristic_length, *logger);
+        solver->minimize(prob, X);
+
+        INFO("solver: " + solver_name);
+        for (int p = 0; p < prob.num_problems(); ++p)
+        {
+            CHECK(solver->status()[p] == Status::GradNormTolerance);
+            CHECK(solver->current_criteria()[p].gradNorm < 1e-8);
+        }
+        CHECK(X.col(0).isApprox(prob.a, 1e-6));
+        CHECK(X.col(1).isApprox(prob.a.cwiseAbs2(), 1e-6));
+    }
+}
+
+class FixedRosenbrock : public FixedProblem<4>
+{
+public:
+    Scalar value(const TVector &x)
+    {
+        Scalar res = 0;
+        for (int i = 0; i < Dim - 1; ++i)
+            res += 100 * (x[i + 1] - x[i] * x[i]) * (x[i + 1] - x[i] * x[i]) + (1 - x[i]) * (1 - x[i]);
+        return res;
+    }
+
+    void gradient(const TVector &x, TVector &grad)
+    {
+        grad.setZero();
+        for (int i = 0; i < Dim - 1; ++i)
+        {
+            const Scalar t = x[i + 1] - x[i] * x[i];
+            grad[i] += -400 * t * x[i] - 2 * (1 - x[i]);
+            grad[i + 1] += 200 * t;
+        }
+    }
+
+    void hessian(const TVector &x, TMatrix &hessian)
+    {
+        hessian.setZero();
+        for (int i = 0; i < Dim - 1; ++i)
+        {
+            hessian(i, i) += 1200 * x[i] * x[i] - 400 * x[i + 1] + 2;
+            hessian(i, i + 1) -= 400 * x[i];
+            hessian(i + 1, i) -= 400 * x[i];
+            hessian(i + 1, i + 1) += 200;
+        }
+    }
+};
+
+TEST_CASE("fixed-size", "[solver]")
+{
+    json solver_params;
+    solver_params["max_iterations"] = 1000;
+    solver_params["grad_norm"] = 1e-8;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_fixed");
+    logger->set_level(spdlog::level::err);
+
+    for (const std::string solver_name : {"Newton", "BFGS"})
+    {
+        solver_params["solver"] = solver_name;
+        const json params = FixedSolverBase::validate(solver_params, *logger);
+
+        FixedSolver<4> solver(params, characteristic_length, *logger);
+        FixedRosenbrock prob;
+
+        FixedSolver<4>::TVector x(-1.2, 1, -1.2, 1);
+        solver.minimize(prob, x);
+
+        INFO("solver: " + solver_name);
+        CHECK(solver.status() == Status::GradNormTolerance);
+        CHECK(x.isApprox(FixedSolver<4>::TVector::Ones(), 1e-6));
+
+        // The solver can be reused without validating the parameters again
+        x << 2, 2, 2, 2;
+        solver.minimize(prob, x);
+        CHECK(solver.status() == Status::GradNormTolerance);
+    }
+}
+
+TEST_CASE("checkpoint", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["max_iterations"] = 1000;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_checkpoint");
+    logger->set_level(spdlog::level::err);
+
+    Rosenbrock prob;
+    const TestProblem::TVector x0 = TestProblem::TVector::Constant(prob.size(), -1.5);
+
+    for (const std::string solver_name : {"L-BFGS", "BFGS", "Newton"})
+    {
+        INFO("solver: " + solver_name);
+        solver_params["solver"] = solver_name;
+        linear_solver_params["solver"] = solver_name == "BFGS" ? "Eigen::LDLT" : "Eigen::SimplicialLDLT";
+
+        // Uninterrupted run
+        TestProblem::TVector x_ref = x0;
+        auto ref_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        ref_solver->minimize(prob, x_ref);
+
+        // Interrupted after a few iterations...
+        json interrupted_params = solver_params;
+        interrupted_params["max_iterations"] = 5;
+        interrupted_params["allow_out_of_iterations"] = true;
+        TestProblem::TVector x = x0;
+        auto solver = Solver::create(interrupted_params, linear_solver_params, characteristic_length, *logger);
+        solver->minimize(prob, x);
+        REQUIRE(solver->current_criteria().iterations == 5);
+
+        std::stringstream state;
+        solver->save_state(state, x);
+
+        // ...and resumed by another solver
+        auto resumed_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        TestProblem::TVector x_resumed;
+        resumed_solver->load_state(state, x_resumed);
+        CHECK(x_resumed == x);
+        resumed_solver->minimize(prob, x_resumed);
+
+        CHECK(resumed_solver->current_criteria().iterations == ref_solver->current_criteria().iterations);
+        CHECK((x_resumed - x_ref).norm() < 1e-12);
+    }
+
+    SECTION("mismatch")
+    {
+        solver_params["solver"] = "L-BFGS";
+        auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        TestProblem::TVector x = x0;
+        std::stringstream state;
+        solver->save_state(state, x);
+
+        solver_params["solver"] = "BFGS";
+        linear_solver_params["solver"] = "Eigen::LDLT";
+        auto other_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        CHECK_THROWS(other_solver->load_state(state, x));
+
+        std::stringstream garbage("not a checkpoint");
+        CHECK_THROWS(solver->load_state(garbage, x));
+    }
+
+    SECTION("BFGS update")
+    {
+        solver_params["solver"] = "BFGS";
+        solver_params["max_iterations"] = 5;
+        solver_params["allow_out_of_iterations"] = true;
+        linear_solver_params["solver"] = "Eigen::LDLT";
+
+        solver_params["BFGS"]["update"] = "InverseHessian";
+        auto inverse_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        TestProblem::TVector x = x0;
+        inverse_solver->minimize(prob, x);
+        std::stringstream state;
+        inverse_solver->save_state(state, x);
+
+        // The inverse approximation must not be read as the Hessian
+        solver_params["BFGS"]["update"] = "Hessian";
+        auto hessian_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        TestProblem::TVector x_loaded;
+        CHECK_THROWS(hessian_solver->load_state(state, x_loaded));
+
+        state.clear();
+        state.seekg(0);
+        solver_params["BFGS"]["update"] = "InverseHessian";
+        auto other_inverse_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+        CHECK_NOTHROW(other_inverse_solver->load_state(state, x_loaded));
+        CHECK(x_loaded == x);
+    }
+}
+
+TEST_CASE("warm-start", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["max_iterations"] = 1000;
+    solver_params["advanced"]["warm_start"] = true;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_warm_start");
+    logger->set_level(spdlog::level::err);
+
+    Rosenbrock prob;
+    const TestProblem::TVector x0 = TestProblem::TVector::Constant(prob.size(), -1.5);
+
+    for (const std::string solver_name : {"L-BFGS", "BFGS", "Newton"})
+    {
+        INFO("solver: " + solver_name);
+        solver_params["solver"] = solver_name;
+        linear_solver_params["solver"] = solver_name == "BFGS" ? "Eigen::LDLT" : "Eigen::SimplicialLDLT";
+
+        auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+
+        // A sequence of nearby problems, as in a time-stepping loop
+        TestProblem::TVector x = x0;
+        for (int step = 0; step < 3; ++step)
+        {
+            if (step > 0)
+                x.array() += 0.1;
+            solver->minimize(prob, x);
+            CHECK(is_converged_status(solver->status()));
+            // BFGS may end in the local minimum of the 10D Rosenbrock
+            TestProblem::TVector g;
+            prob.gradient(x, g);
+            CHECK(std::min((x - prob.solutions()[0]).norm(), g.norm()) < 1e-4);
+        }
+    }
+}
+
+TEST_CASE("telemetry", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["max_iterations"] = 1000;
+    solver_params["advanced"]["telemetry_size"] = 4;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const std::string path = (std::filesystem::temp_directory_path() / "polysolve_telemetry.jsonl").string();
+    solver_params["advanced"]["telemetry_path"] = path;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_telemetry");
+    logger->set_level(spdlog::level::err);
+
+    Rosenbrock prob;
+    TestProblem::TVector x = TestProblem::TVector::Constant(prob.size(), -1.5);
+
+    auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+    solver->minimize(prob, x);
+
+    const size_t iterations = solver->current_criteria().iterations;
+    REQUIRE(iterations > 4);
+
+    // Only the last records are kept, oldest first
+    const Telemetry &telemetry = solver->telemetry();
+    CHECK(telemetry.total() == iterations);
+    REQUIRE(telemetry.size() == 4);
+    for (size_t i = 0; i < telemetry.size(); ++i)
+        CHECK(telemetry[i].iteration == iterations - 4 + i);
+    CHECK(telemetry.back().linear_residual >= 0);
+    CHECK(telemetry.back().linear_iterations == -1); // direct solver
+    CHECK(telemetry.back().step_size > 0);
+    CHECK(telemetry.to_json().size() == 4);
+
+    // The linear solves do not accumulate in the info
+    CHECK(solver->info()["internal_solver"].size() <= 1);
+
+    // Every record is streamed
+    solver->telemetry().close_sink();
+    std::ifstream in(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(in, line))
+    {
+        CHECK(json::parse(line)["iteration"] == lines);
+        ++lines;
+    }
+    CHECK(lines == iterations);
+    in.close();
+    std::filesystem::remove(path);
+
+    // Iterative solvers report their iterations
+    solver_params["advanced"].erase("telemetry_path");
+    linear_solver_params["solver"] = "Eigen::ConjugateGradient";
+    QuadraticProblem quadratic;
+    TestProblem::TVector y = TestProblem::TVector::Zero(quadratic.size());
+    auto iterative_solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+    iterative_solver->minimize(quadratic, y);
+    REQUIRE(iterative_solver->telemetry().size() > 0);
+    CHECK(iterative_solver->telemetry().back().linear_iterations >= 0);
+}
+
+// Records the solver info seen by post_step
+class InfoRosenbrock : public Rosenbrock
+{
+public:
+    void post_step(const PostStepData &data) override
+    {
+        line_search_iterations.push_back(data.info().value("line_search_iterations", -1));
+        if (data.record)
+            record_matches &= data.record->energy == data.solver_info["energy"].get<double>();
+    }
+
+    std::vector<int> line_search_iterations;
+    bool record_matches = true;
+};
+
+TEST_CASE("post-step-info", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_post_step_info");
+    logger->set_level(spdlog::level::err);
+
+    InfoRosenbrock prob;
+    TestProblem::TVector x = TestProblem::TVector::Constant(prob.size(), -1.5);
+
+    auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+    solver->minimize(prob, x);
+
+    // info() gathers the strategies and line search fields, starting with the call before the first iteration
+    REQUIRE(prob.line_search_iterations.size() > 1);
+    for (const int iterations : prob.line_search_iterations)
+        CHECK(iterations >= 0);
+    CHECK(prob.line_search_iterations.back() == solver->info()["line_search_iterations"].get<int>());
+    CHECK(prob.record_matches);
+}
+
+#ifdef POLYSOLVE_WITH_TRACING
+TEST_CASE("tracing", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_tracing");
+    logger->set_level(spdlog::level::err);
+
+    Rosenbrock prob;
+    TestProblem::TVector x = TestProblem::TVector::Constant(prob.size(), -1.5);
+
+    auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+
+    tracing::clear();
+    tracing::enable();
+    solver->minimize(prob, x);
+    tracing::enable(false);
+
+    const size_t iterations = solver->current_criteria().iterations;
+    REQUIRE(tracing::size() > 0);
+    CHECK(tracing::dropped() == 0);
+
+    // Nothing is recorded while disabled
+    const size_t n_spans = tracing::size();
+    x.setConstant(-1.5);
+    solver->minimize(prob, x);
+    CHECK(tracing::size() == n_spans);
+
+    const json trace = tracing::chrome_trace();
+    REQUIRE(trace["traceEvents"].size() == n_spans);
+
+    size_t n_iterations = 0, n_solver = 0, n_linear_solves = 0;
+    double solver_end = 0;
+    for (const json &e : trace["traceEvents"])
+    {
+        CHECK(e["ph"] == "X");
+        CHECK(e["dur"].get<double>() >= 0);
+        const std::string name = e["name"];
+        if (name == "iteration")
+            ++n_iterations;
+        else if (name == "nonlinear solver")
+        {
+            ++n_solver;
+            solver_end = e["ts"].get<double>() + e["dur"].get<double>();
+        }
+        else if (name == "linear solve")
+            ++n_linear_solves;
+    }
+    CHECK(n_solver == 1);
+    CHECK(n_iterations >= iterations);
+    CHECK(n_linear_solves >= iterations);
+
+    // Parents come before their children and contain them
+    CHECK(trace["traceEvents"][0]["name"] == "nonlinear solver");
+    for (const json &e : trace["traceEvents"])
+        CHECK(e["ts"].get<double>() + e["dur"].get<double>() <= solver_end + 1e-3);
+
+    tracing::clear();
+    CHECK(tracing::size() == 0);
+}
+#endif
+
+#ifdef POLYSOLVE_WITH_PERF_COUNTERS
+TEST_CASE("perf-counters", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["max_iterations"] = 1000;
+    solver_params["advanced"]["perf_counters"] = true;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_perf_counters");
+    logger->set_level(spdlog::level::err);
+
+    Rosenbrock prob;
+    TestProblem::TVector x = TestProblem::TVector::Constant(prob.size(), -1.5);
+
+    auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+
+    for (int run = 0; run < 2; ++run)
+    {
+        x.setConstant(-1.5);
+        solver->minimize(prob, x);
+        CHECK(!perf::is_enabled());
+
+        // Only the phases of the last minimize are reported
+        const json &counters = solver->info()["perf_counters"];
+        REQUIRE(counters.contains("nonlinear solver"));
+        CHECK(counters["nonlinear solver"]["count"] == 1);
+        REQUIRE(counters.contains("linear solver: factorize"));
+        CHECK(counters["linear solver: factorize"]["count"].get<size_t>() > 0);
+        CHECK(counters["linear solve"]["count"].get<size_t>() >= counters["linear solver: solve"]["count"].get<size_t>());
+
+        for (const auto &[name, phase] : counters.items())
+        {
+            CHECK(phase["count"].get<size_t>() > 0);
+            CHECK(phase["time"].get<double>() >= 0);
+            CHECK(phase["time"].get<double>() <= counters["nonlinear solver"]["time"].get<double>() + 1e-6);
+        }
+
+        const json &solve = counters["nonlinear solver"];
+        if (perf::available() && solve.contains("cycles"))
+        {
+            CHECK(solve["cycles"].get<uint64_t>() >= counters["linear solver: factorize"]["cycles"].get<uint64_t>());
+            if (solve.contains("instructions_per_cycle"))
+                CHECK(solve["instructions_per_cycle"].get<double>() > 0);
+        }
+    }
+}
+#endif
+
+/// Cancels its token from the objective after a number of gradients, as another thread would
+class CancellingRosenbrock : public Rosenbrock
+{
+public:
+    CancellingRosenbrock(const std::shared_ptr<CancellationToken> &token, const int cancel_after)
+        : token(token), cancel_after(cancel_after) {}
+
+    void gradient(const TVector &x, TVector &gradv) override
+    {
+        Rosenbrock::gradient(x, gradv);
+        if (++gradients == cancel_after)
+            token->cancel();
+    }
+
+    std::shared_ptr<CancellationToken> token;
+    const int cancel_after;
+    int gradients = 0;
+};
+
+TEST_CASE("budget-cancellation", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_budget_cancellation");
+    logger->set_level(spdlog::level::off);
+
+    const TestProblem::TVector x0 = TestProblem::TVector::Constant(10, -1.5);
+
+    for (const std::string solver_name : {"Newton", "L-BFGS", "TrustRegion"})
+    {
+        INFO("solver: " + solver_name);
+        solver_params["solver"] = solver_name;
+
+        SECTION("evaluation budget " + solver_name)
+        {
+            solver_params["advanced"]["max_evaluations"] = 5;
+            auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+
+            Rosenbrock prob;
+            TestProblem::TVector x = x0;
+            solver->minimize(prob, x);
+            CHECK(solver->status() == Status::BudgetExhausted);
+            CHECK(solver->current_criteria().evaluations >= 5);
+            CHECK(solver->info()["evaluations"].get<int>() > 0);
+            CHECK(prob.value(x) <= prob.value(x0));
+        }
+
+        SECTION("time budget " + solver_name)
+        {
+            solver_params["advanced"]["max_time"] = 1e-9;
+            auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+
+            Rosenbrock prob;
+            TestProblem::TVector x = x0;
+            solver->minimize(prob, x);
+            CHECK(solver->status() == Status::BudgetExhausted);
+            CHECK(x == x0);
+        }
+
+        SECTION("cancelled " + solver_name)
+        {
+            auto solver = Solver::create(solver_params, linear_solver_params, characteristic_length, *logger);
+            auto token = std::make_shared<CancellationToken>();
+            solver->set_cancellation_token(token);
+
+            // Cancelled before the first iteration
+            Rosenbrock prob;
+            TestProblem::TVector x = x0;
+            token->cancel();
+            solver->minimize(prob, x);
+            CHECK(solver->status() == Status::Cancelled);
+            CHECK(x == x0);
+
+            // Cancelled in the middle of the solve, x is the last accepted iterate
+            token->reset();
+            CancellingRosenbrock cancelling(token, 3);
+            x = x0;
+            solver->minimize(cancelling, x);
+            CHECK(solver->status() == Status::Cancelled);
+            CHECK(solver->current_criteria().iterations < 3);
+            CHECK(cancelling.value(x) <= cancelling.value(x0));
+
+            // The token stops cancelling once reset
+            token->reset();
+            x = x0;
+            solver->minimize(prob, x);
+            CHECK(is_converged_status(solver->status()));
+        }
+    }
+}
+
+class JacobiRosenbrock : public Rosenbrock
+{
+public:
+    bool hessian_preconditioner(const TVector &x, THessian &preconditioner) override
+    {
+        hessian(x, preconditioner);
+        const TVector d = preconditioner.diagonal();
+        preconditioner = sparse_identity(x.size(), x.size());
+        preconditioner.diagonal() = d.cwiseAbs();
+        return true;
+    }
+};
+
+TEST_CASE("nonlinear-matrix-free", "[solver]")
+{
+    JacobiRosenbrock prob;
+
+    TestProblem::TVector x(prob.size()), v(prob.size()), hv;
+    x.setRandom();
+    v.setRandom();
+    Problem::THessian hessian;
+    prob.hessian(x, hessian);
+    prob.hessian_vector_product(x, v, hv);
+    CHECK((hv - hessian * v).norm() <= 1e-6 * (hessian * v).norm());
+
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "MatrixFreeNewton";
+    solver_params["max_iterations"] = 1000;
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_matrix_free");
+    logger->set_level(spdlog::level::info);
+
+    for (const bool use_preconditioner : {false, true})
+    {
+        solver_params["MatrixFreeNewton"]["use_preconditioner"] = use_preconditioner;
+        for (int i = 0; i < N_RANDOM; ++i)
+        {
+            x.setRandom();
+            x /= 10;
+            x += prob.solutions()[0];
+
+            auto solver = Solver::create(solver_params,
+                                         linear_solver_params,
+                                         characteristic_length,
+                                         *logger);
+            solver->minimize(prob, x);
+
+            INFO("use_preconditioner: " << use_preconditioner);
+            CHECK((x - prob.solutions()[0]).norm() < 1e-7);
+            CHECK(solver->info()["internal_solver"].back()["preconditioned"] == use_preconditioner);
+        }
+    }
+}
+
+TEST_CASE("nonlinear-trust-region", "[solver]")
+{
+    std::vector<std::unique_ptr<TestProblem>> problems;
+    problems.push_back(std::make_unique<QuadraticProblem>());
+    problems.push_back(std::make_unique<Rosenbrock>());
+    problems.push_back(std::make_unique<Sphere>());
+    problems.push_back(std::make_unique<Beale>());
+
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "TrustRegion";
+    solver_params["max_iterations"] = 1000;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_trust_region");
+    logger->set_level(spdlog::level::info);
+    TestProblem::TVector g;
+
+    for (const std::string subproblem : {"SteihaugCG", "Dogleg"})
+    {
+        solver_params["TrustRegion"]["subproblem"] = subproblem;
+        for (auto &prob : problems)
+        {
+            TestProblem::TVector x(prob->size());
+            for (int i = 0; i < N_RANDOM; ++i)
+            {
+                x.setRandom();
+                x /= 10;
+                x += prob->solutions()[0];
+
+                auto solver = Solver::create(solver_params,
+                                             linear_solver_params,
+                                             characteristic_length,
+                                             *logger);
+                solver->minimize(*prob, x);
+
+                double err = std::numeric_limits<double>::max();
+                for (auto sol : prob->solutions())
+                    err = std::min(err, (x - sol).norm());
+                if (err >= 1e-7)
+                {
+                    prob->gradient(x, g);
+                    err = g.norm();
+                }
+                INFO("subproblem: " + subproblem + " problem " + prob->name());
+                CHECK(err < 1e-7);
+            }
+        }
+    }
+}
+
+class BatchCountingRosenbrock : public Rosenbrock
+{
+public:
+    void value_batch(const TVector &x, const TVector &direction, const Eigen::VectorXd &alphas,
+                     Eigen::VectorXd &fs, Eigen::VectorXi &valid) override
+    {
+        ++batches;
+        in_batch = true;
+        Rosenbrock::value_batch(x, direction, alphas, fs, valid);
+        in_batch = false;
+    }
+
+    void solution_changed(const TVector &new_x) override
+    {
+        if (!in_batch)
+            ++updates_in_line_search;
+    }
+
+    void line_search_begin(const TVector &x0, const TVector &x1) override
+    {
+        updates_in_line_search = 0;
+    }
+
+    void line_search_end() override
+    {
+        max_updates_in_line_search = std::max(max_updates_in_line_search, updates_in_line_search);
+    }
+
+    int batches = 0;
+    bool in_batch = false;
+    int updates_in_line_search = 0;
+    int max_updates_in_line_search = 0;
+};
+
+TEST_CASE("line-search-batch", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "GradientDescent";
+    solver_params["max_iterations"] = 50;
+    solver_params["allow_out_of_iterations"] = true;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_batch");
+    logger->set_level(spdlog::level::err);
+
+    for (const std::string ls : {"Backtracking", "Armijo", "RobustArmijo"})
+    {
+        solver_params["line_search"]["method"] = ls;
+
+        TestProblem::TVector x_serial, x_batch;
+        int serial_iterations = 0;
+        for (const int batch_size : {1, 4})
+        {
+            solver_params["line_search"]["batch_size"] = batch_size;
+
+            BatchCountingRosenbrock prob;
+            TestProblem::TVector x = TestProblem::TVector::Zero(prob.size());
+
+            auto solver = Solver::create(solver_params,
+                                         linear_solver_params,
+                                         characteristic_length,
+                                         *logger);
+            solver->minimize(prob, x);
+
+            INFO("line search: " + ls);
+            if (batch_size == 1)
+            {
+                x_serial = x;
+                serial_iterations = solver->current_criteria().iterations;
+                CHECK(prob.batches == 0);
+            }
+            else
+            {
+                CHECK((x - x_serial).norm() == 0);
+                CHECK(solver->current_criteria().iterations == serial_iterations);
+                CHECK(prob.batches > 0);
+                // Only the accepted step is set again after the batch evaluation
+                if (ls != "RobustArmijo")
+                    CHECK(prob.max_updates_in_line_search == 1);
+            }
+        }
+    }
+}
+
+class EvaluationCountingRosenbrock : public Rosenbrock
+{
+public:
+    double value(const TVector &x) override
+    {
+        ++values;
+        count(x, value_points);
+        return Rosenbrock::value(x);
+    }
+
+    void gradient(const TVector &x, TVector &grad) override
+    {
+        ++gradients;
+        count(x, gradient_points);
+        Rosenbrock::gradient(x, grad);
+    }
+
+    void value_and_gradient(const TVector &x, double &f, TVector &grad) override
+    {
+        ++values_and_gradients;
+        count(x, value_points);
+        count(x, gradient_points);
+        f = Rosenbrock::value(x);
+        Rosenbrock::gradient(x, grad);
+    }
+
+    void post_step(const PostStepData &data) override
+    {
+        repeated_per_iteration.push_back(repeated);
+        repeated = 0;
+    }
+
+    int values = 0;
+    int gradients = 0;
+    int values_and_gradients = 0;
+    /// Evaluations of a value or gradient already evaluated at the same point, per iteration
+    std::vector<int> repeated_per_iteration;
+
+private:
+    void count(const TVector &x, std::vector<TVector> &points)
+    {
+        for (const TVector &p : points)
+        {
+            if (p.size() == x.size() && p == x)
+            {
+                ++repeated;
+                return;
+            }
+        }
+        points.push_back(x);
+    }
+
+    std::vector<TVector> value_points;
+    std::vector<TVector> gradient_points;
+    int repeated = 0;
+};
+
+TEST_CASE("evaluation-cache", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["line_search"]["method"] = "Backtracking";
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_cache");
+    logger->set_level(spdlog::level::err);
+
+    TestProblem::TVector x_uncached;
+    int uncached_values = 0, uncached_gradients = 0, uncached_iterations = 0;
+    for (const bool cache : {false, true})
+    {
+        solver_params["advanced"]["cache_evaluations"] = cache;
+
+        EvaluationCountingRosenbrock prob;
+        TestProblem::TVector x = TestProblem::TVector::Zero(prob.size());
+
+        auto solver = Solver::create(solver_params,
+                                     linear_solver_params,
+                                     characteristic_length,
+                                     *logger);
+        solver->minimize(prob, x);
+
+        if (!cache)
+        {
+            x_uncached = x;
+            uncached_values = prob.values + prob.values_and_gradients;
+            uncached_gradients = prob.gradients + prob.values_and_gradients;
+            uncached_iterations = solver->current_criteria().iterations;
+        }
+        else
+        {
+            CHECK((x - x_uncached).norm() == 0);
+            CHECK(solver->current_criteria().iterations == uncached_iterations);
+            CHECK(prob.values + prob.values_and_gradients < uncached_values);
+            CHECK(prob.gradients + prob.values_and_gradients <= uncached_gradients);
+            CHECK(solver->info()["cached_evaluations"].get<int>() > 0);
+
+            // Neither the accepted point nor the first trial step is evaluated again
+            REQUIRE(prob.repeated_per_iteration.size() == solver->current_criteria().iterations + 1);
+            for (int i = 0; i < prob.repeated_per_iteration.size(); ++i)
+            {
+                INFO("iteration " << i);
+                CHECK(prob.repeated_per_iteration[i] == 0);
+            }
+        }
+    }
+}
+
+// Energy shifted by a constant raised in post_step, so it changes at a fixed x
+class PostStepShiftedRosenbrock : public Rosenbrock
+{
+public:
+    double value(const TVector &x) override { return Rosenbrock::value(x) + shift; }
+
+    void post_step(const PostStepData &data) override { shift += 1; }
+
+    bool callbacks_change_energy() const override { return true; }
+
+    double shift = 0;
+};
+
+TEST_CASE("evaluation-cache-post-step", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["line_search"]["method"] = "Backtracking";
+    solver_params["advanced"]["cache_evaluations"] = true;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_cache_post_step");
+    logger->set_level(spdlog::level::err);
+
+    PostStepShiftedRosenbrock prob;
+    TestProblem::TVector x = TestProblem::TVector::Zero(prob.size());
+
+    auto solver = Solver::create(solver_params,
+                                 linear_solver_params,
+                                 characteristic_length,
+                                 *logger);
+    solver->minimize(prob, x);
+
+    // The last energy is evaluated after the last post_step, so it must see the last shift
+    REQUIRE(solver->current_criteria().iterations > 1);
+    CHECK(solver->info()["energy"].get<double>() == prob.value(x));
+}
+
+TEST_CASE("value-and-gradient", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["advanced"]["cache_evaluations"] = false;
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_value_and_gradient");
+    logger->set_level(spdlog::level::err);
+
+    for (const std::string ls : {"Backtracking", "Armijo"})
+    {
+        solver_params["line_search"]["method"] = ls;
+
+        EvaluationCountingRosenbrock prob;
+        TestProblem::TVector x = TestProblem::TVector::Zero(prob.size());
+
+        auto solver = Solver::create(solver_params,
+                                     linear_solver_params,
+                                     characteristic_length,
+                                     *logger);
+        solver->minimize(prob, x);
+
+        // Every gradient is evaluated together with the energy
+        INFO("line search: " + ls);
+        CHECK((x - prob.solutions()[0]).norm() < 1e-7);
+        CHECK(prob.values_and_gradients > 0);
+        CHECK(prob.gradients == 0);
+    }
+}
+
+class PatternRosenbrock : public Rosenbrock
+{
+public:
+    void hessian(const TVector &x, THessian &hessian) override
+    {
+        ++hessians;
+        Rosenbrock::hessian(x, hessian);
+    }
+
+    void hessian(const TVector &x, Eigen::MatrixXd &hessian) override
+    {
+        ++dense_hessians;
+        Rosenbrock::hessian(x, hessian);
+    }
+
+    bool hessian_pattern(THessian &pattern) override
+    {
+        // Only consecutive variables are coupled
+        std::vector<Eigen::Triplet<double>> entries;
+        for (int i = 0; i < size(); ++i)
+            for (int j = std::max(i - 1, 0); j <= std::min(i + 1, size() - 1); ++j)
+                entries.emplace_back(i, j, 0);
+        pattern.resize(size(), size());
+        pattern.setFromTriplets(entries.begin(), entries.end());
+        pattern.makeCompressed();
+        return true;
+    }
+
+    void hessian_values(const TVector &x, Eigen::Ref<Eigen::VectorXd> values) override
+    {
+        ++refills;
+        THessian pattern, h;
+        hessian_pattern(pattern);
+        Rosenbrock::hessian(x, h);
+        for (int k = 0, i = 0; k < pattern.outerSize(); ++k)
+            for (THessian::InnerIterator it(pattern, k); it; ++it)
+                values[i++] = h.coeff(it.row(), it.col());
+    }
+
+    int hessians = 0;
+    int dense_hessians = 0;
+    int refills = 0;
+};
+
+TEST_CASE("hessian-pattern", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    linear_solver_params["solver"] = "Eigen::SimplicialLDLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_pattern");
+    logger->set_level(spdlog::level::err);
+
+    for (const bool regularized : {false, true})
+    {
+        // Only the regularized variant, starting from the smallest shift
+        solver_params["Newton"]["force_psd_projection"] = regularized;
+        solver_params["Newton"]["use_psd_projection"] = !regularized;
+
+        PatternRosenbrock prob;
+        TestProblem::TVector x = TestProblem::TVector::Zero(prob.size());
+
+        auto solver = Solver::create(solver_params,
+                                     linear_solver_params,
+                                     characteristic_length,
+                                     *logger);
+        solver->minimize(prob, x);
+
+        INFO("regularized: " << regularized);
+        CHECK((x - prob.solutions()[0]).norm() < 1e-7);
+        CHECK(prob.refills > 0);
+        CHECK(prob.hessians == 0);
+    }
+}
+
+TEST_CASE("regularization-ladder", "[solver]")
+{
+    json solver_params, linear_solver_params;
+    solver_params["solver"] = "Newton";
+    solver_params["Newton"]["force_psd_projection"] = true;
+    solver_params["Newton"]["use_psd_projection"] = false;
+    // Fails to factorize until the shifted Hessian is positive definite
+    linear_solver_params["solver"] = "Eigen::SimplicialLLT";
+
+    const double characteristic_length = 1;
+
+    static std::shared_ptr<spdlog::logger> logger = spdlog::stdout_color_mt("test_logger_ladder");
+    logger->set_level(spdlog::level::err);
+
+    // The Hessian at (0, 1, 0, 1, ...) has a -398 eigenvalue, the first shift
+    // of the ladder 1e-8, 1e-7, ... making it positive definite is 1e3
+    PatternRosenbrock prob;
+    TestProblem::TVector x(prob.size());
+    for (int i = 0; i < x.size(); ++i)
+        x[i] = i % 2;
+
+    SECTION("first step")
+    {
+        solver_params["max_iterations"] = 1;
+        solver_params["allow_out_of_iterations"] = true;
+
+        auto solver = Solver::create(solver_params,
+                                     linear_solver_params,
+                                     characteristic_length,
+                                     *logger);
+        solver->minimize(prob, x);
+
+        CHECK(solver->info()["reg_weight"].get<double>() == Approx(1e3));
+        // Larger shifts at the same point reuse the assembled Hessian
+        CHECK(prob.refills == 1);
+        CHECK(prob.hessians == 0);
+
+        // Another minimize starts from the minimum shift again
+        QuadraticProblem quadratic;
+        TestProblem::TVector y = TestProblem::TVector::Zero(quadratic.size());
+        solver->minimize(quadratic, y);
+        CHECK(solver->info()["reg_weight"].get<double>() == Approx(1e-8));
+    }
+
+    SECTION("exhausted")
+    {
+        // Gives up at the maximum and falls back to gradient descent without raising it again
+        solver_params["Newton"]["reg_weight_max"] = 100;
+        solver_params["max_iterations"] = 1;
+        solver_params["allow_out_of_iterations"] = true;
+
+        auto solver = Solver::create(solver_params,
+                                     linear_solver_params,
+                                     characteristic_length,
+                                     *logger);
+        solver->minimize(prob, x);
+
+        CHECK(solver->info()["reg_weight"].get<double>() == Approx(100));
+        CHECK(prob.refills == 1);
+    }
+
+    SECTION("dense")
+    {
+        solver_params["max_iterations"] = 1;
+        solver_params["allow_out_of_iterations"] = true;
+
+        TestProblem::TVector x_sparse = x;
+        auto sparse_solver = Solver::create(solver_params,
+                                            linear_solver_params,
+                                            characteristic_length,
+                                            *logger);
+        sparse_solver->minimize(prob, x_sparse);
+
+        solver_params["solver"] = "DenseNewton";
+        linear_solver_params["solver"] = "Eigen::LLT";
+
+        auto solver = Solver::create(solver_params,
+                                     linear_solver_params,
+                                     characteristic_length,
+                                     *logger);
+        solver->minimize(prob, x);
+
+        CHECK(solver->info()["reg_weight"].get<double>() == Approx(1e3));
+        CHECK(prob.dense_hessians == 1);
+        // The in-place factorizations of the failed shifts do not leak into the next ones
+        CHECK((x - x_sparse).norm() < 1e-8);
+    }
+}
+
 TEST_CASE("nonlinear-gradient-fd", "[solver]")
 {
     test_solvers_gradient_fd(false);